@@ -4,6 +4,7 @@
 #
 #-------------------------------------------------
 QT       += core gui widgets winextras
+CONFIG   += c++17
 
 TARGET = WC3ModManager
 TEMPLATE = app
@@ -42,11 +43,28 @@ SOURCES += \
     main_launcher.cpp \
     main_core.cpp \
     config.cpp \
-    thread.cpp
+    thread.cpp \
+    scanengine.cpp \
+    modindex.cpp \
+    modwatcher.cpp \
+    dirlister.cpp \
+    copyengine.cpp \
+    reaper.cpp \
+    backupmanifest.cpp \
+    overlay.cpp \
+    modstore.cpp \
+    modmanifest.cpp \
+    hashengine.cpp \
+    mpqarchive.cpp \
+    mpqwriter.cpp \
+    conflictindex.cpp \
+    layerstack.cpp
 
 HEADERS += \
     _dic.h \
     _utils.h \
+    _throttle.h \
+    _timeline.h \
     mainwindow.h \
     _msgr.h \
     _moddata.h \
@@ -59,7 +77,22 @@ HEADERS += \
     config.h \
     thread.h \
     thread_pvt.h \
-    threadbase.h
+    threadbase.h \
+    scanengine.h \
+    modindex.h \
+    modwatcher.h \
+    dirlister.h \
+    copyengine.h \
+    reaper.h \
+    backupmanifest.h \
+    overlay.h \
+    modstore.h \
+    modmanifest.h \
+    hashengine.h \
+    mpqarchive.h \
+    mpqwriter.h \
+    conflictindex.h \
+    layerstack.h
 
 RESOURCES += \
     icons.qrc \
@@ -1,7 +1,9 @@
 #ifndef DIC_H
 #define DIC_H
 
-#include "_uo_map_qs.h"
+#include "threadbase.h"
+#include <QString>
+#include <array>
 
 //****************************************************************************
 //**    LEGEND      **********************************************************
@@ -23,285 +25,355 @@
 //*****************************************************************************
 //*****************************************************************************
 
+/* Every string is a UTF-16 literal, the composed ones written out in full, so the dictionary is constants only:
+ * one definition each (inline), nothing to build at startup. Where a QString is wanted a Str converts to one that
+ * points at the literal (QString::fromRawData, the text isn't copied); arg() returns a QString. */
 namespace d {
-static const QString
+class Str
+{
+         const char16_t *text;
+         int             size;
 
-    X_X = QStringLiteral(u"%0 %1"),
+         template<typename T> static const T &str(const T &arg) { return arg; }
+         static QString str(const Str &arg) { return arg.toString(); }
 
-    WC3MM = QStringLiteral(u"WC3 Mod Manager"),
+public:  template<std::size_t N> constexpr Str(const char16_t (&text)[N]) : text(text), size(int(N)-1) {}
+
+         QString toString() const { return QString::fromRawData(reinterpret_cast<const QChar *>(text), size); }
+         operator QString() const { return toString(); }
+
+         template<typename... Args> QString arg(const Args &...args) const { return toString().arg(str(args)...); }
+};
+
+inline constexpr Str
+
+    X_X = u"%0 %1",
+
+    WC3MM = u"WC3 Mod Manager",
 
 //LAUNCH STRINGS
-    WC3_EXE  = QStringLiteral(u"Warcraft III.exe"),
-    WC3X_EXE = QStringLiteral(u"Frozen Throne.exe"),
-    WC3R_EXE = QStringLiteral(u"Frozen Throne.exe or Reforged's Warcraft III.exe"),
-    WE_EXE   = QStringLiteral(u"World Editor.exe"),
+    WC3_EXE  = u"Warcraft III.exe",
+    WC3X_EXE = u"Frozen Throne.exe",
+    WC3R_EXE = u"Frozen Throne.exe or Reforged's Warcraft III.exe",
+    WE_EXE   = u"World Editor.exe",
 
-    L_NONE = QStringLiteral(u"<none>"),
+    L_NONE = u"<none>",
+    L_ALL  = u"<all>",
 
-    _X          = QStringLiteral(u"-%0"),
-    C_LAUNCH    = QStringLiteral(u"launch"),
-    C_VERSION   = QStringLiteral(u"version"),
-    C_NATIVE    = QStringLiteral(u"native"),
+    _X          = u"-%0",
+    C_LAUNCH    = u"launch",
+    C_VERSION   = u"version",
+    C_NATIVE    = u"native",
+    C_VERIFY    = u"verify",
 
-    V_CLASSIC   = QStringLiteral(u"classic"),
-    V_EXPANSION = QStringLiteral(u"expansion"),
-    V_WE        = QStringLiteral(u"worldedit"),
+    V_CLASSIC   = u"classic",
+    V_EXPANSION = u"expansion",
+    V_WE        = u"worldedit",
 
 //GAME STRINGS
-    WC3         = QStringLiteral(u"Warcraft III"),
-    ROC         = QStringLiteral(u"Reign of Chaos"),
-    TFT         = QStringLiteral(u"The Frozen Throne"),
-    CLASSIC     = QStringLiteral(u"Classic"),
-    EXPANSION   = QStringLiteral(u"Expansion"),
-    WE          = QStringLiteral(u"World Editor"),
+    WC3         = u"Warcraft III",
+    ROC         = u"Reign of Chaos",
+    TFT         = u"The Frozen Throne",
+    CLASSIC     = u"Classic",
+    EXPANSION   = u"Expansion",
+    WE          = u"World Editor",
 
 // GENERAL
-    EXTRAc  = QStringLiteral(u"Extra:"),
-    RESULTc = QStringLiteral(u"Result:"),
-    TOTALc_ = QStringLiteral(u"Total: "),
-
-    lGAME   = QStringLiteral(u"game"),
-    GAME    = QStringLiteral(u"Game"),
-    lMOD    = QStringLiteral(u"mod"),
-    MOD     = QStringLiteral(u"Mod"),
-    lMODS   = QStringLiteral(u"mods"),
-    MODS    = QStringLiteral(u"Mods"),
-
-    FOLDER          = QStringLiteral(u"Folder"),
-    lFOLDER         = QStringLiteral(u"folder"),
-    X_uFOLDER       = X_X.arg("%0", FOLDER),
-    X_FOLDER        = X_X.arg("%0", lFOLDER),
-
-    VERSIONc        = QStringLiteral(u"Version:"),
-    INFO            = QStringLiteral(u"Information"),
-    X_MB            = QStringLiteral(u"%0 MB"),
-    ZERO_MB         = X_MB.arg("0.00"),
-    ALMOST_ZERO_MB  = X_MB.arg("< 0.01"),
-    SIZE            = QStringLiteral(u"Size"),
-    FILES           = QStringLiteral(u"Files"),
-    lFILES          = QStringLiteral(u"files"),
-    lFILE           = QStringLiteral(u"file"),
-    lFILEc_X        = QStringLiteral(u"%0: %1").arg(lFILE, "%0"),
-    X_FILES         = QStringLiteral(u"%0 %1").arg("%0", lFILES),
-    ZERO_FILES      = X_FILES.arg("0"),
-    lFILENAME       = QStringLiteral(u"filename"),
-    lSYMLINK        = QStringLiteral(u"symbolic link"),
-    SHORTCUT        = QStringLiteral(u"Shortcut"),
-    lSHORTCUT       = QStringLiteral(u"shortcut"),
-    SHORTCUT_X      = X_X.arg(SHORTCUT, "%0"),
-    lLOC            = QStringLiteral(u"location"),
-    LOC             = QStringLiteral(u"Location"),
-    X_SETTING       = QStringLiteral(u"%0 setting"),
-    lICON           = QStringLiteral(u"icon"),
-    ICON            = QStringLiteral(u"Icon"),
-    lUNKNOWN        = QStringLiteral(u"unknown"),
+    EXTRAc  = u"Extra:",
+    RESULTc = u"Result:",
+    TOTALc_ = u"Total: ",
+
+    lGAME   = u"game",
+    GAME    = u"Game",
+    lMOD    = u"mod",
+    MOD     = u"Mod",
+    lMODS   = u"mods",
+    MODS    = u"Mods",
+
+    FOLDER          = u"Folder",
+    lFOLDER         = u"folder",
+    X_uFOLDER       = u"%0 Folder",
+    X_FOLDER        = u"%0 folder",
+
+    VERSIONc        = u"Version:",
+    INFO            = u"Information",
+    X_MB            = u"%0 MB",
+    ZERO_MB         = u"0.00 MB",
+    ALMOST_ZERO_MB  = u"< 0.01 MB",
+    SIZE            = u"Size",
+    FILES           = u"Files",
+    lFILES          = u"files",
+    lFILE           = u"file",
+    lFILEc_X        = u"file: %0",
+    X_FILES         = u"%0 files",
+    ZERO_FILES      = u"0 files",
+    X_PERCENT_X     = u"%0 (%1%)",
+    lFILENAME       = u"filename",
+    lSYMLINK        = u"symbolic link",
+    SHORTCUT        = u"Shortcut",
+    lSHORTCUT       = u"shortcut",
+    SHORTCUT_X      = u"Shortcut %0",
+    lLOC            = u"location",
+    LOC             = u"Location",
+    X_SETTING       = u"%0 setting",
+    lICON           = u"icon",
+    ICON            = u"Icon",
+    lUNKNOWN        = u"unknown",
 
 // GENERAL ACTIONS
-    OPEN_X              = QStringLiteral(u"Open %0"),
-    lOPEN_X             = QStringLiteral(u"open %0"),
-    OPENING_X_FOLDER___ = QStringLiteral(u"Opening %0...").arg(X_FOLDER),
-    X_FOLDER_OPENED_    = QStringLiteral(u"%0 opened.").arg(X_FOLDER),
-    CREATE_X            = QStringLiteral(u"Create %0"),
-    lCREATE_X           = QStringLiteral(u"create %0"),
-    lLAUNCHING_X        = QStringLiteral(u"launching %0"),
-    LAUNCHING_X___      = QStringLiteral(u"Launching %0..."),
-    X_LAUNCHED_         = QStringLiteral(u"%0 launched."),
-    lLAUNCH_X           = QStringLiteral(u"launch %0"),
-    LAUNCH_X            = QStringLiteral(u"Launch %0"),
-    lSET                = QStringLiteral(u"set"),
-    SELECT              = QStringLiteral(u"Select"),
-    lSELECTED           = QStringLiteral(u"selected"),
-    PROCESSING      = QStringLiteral(u"Processing"),
+    OPEN_X              = u"Open %0",
+    lOPEN_X             = u"open %0",
+    OPENING_X_FOLDER___ = u"Opening %0 folder...",
+    X_FOLDER_OPENED_    = u"%0 folder opened.",
+    CREATE_X            = u"Create %0",
+    lCREATE_X           = u"create %0",
+    lLAUNCHING_X        = u"launching %0",
+    LAUNCHING_X___      = u"Launching %0...",
+    X_LAUNCHED_         = u"%0 launched.",
+    lLAUNCH_X           = u"launch %0",
+    LAUNCH_X            = u"Launch %0",
+    lSET                = u"set",
+    SELECT              = u"Select",
+    lSELECTED           = u"selected",
+    PROCESSING      = u"Processing",
 
 //RESULT - SUCCESS
-    READY_              = QStringLiteral(u"Ready."),
-    X_ENABLED_          = QStringLiteral(u"%0 enabled."),
-    X_DISABLED_         = QStringLiteral(u"%0 disabled."),
-    lDONE_              = QStringLiteral(u"done."),
-    X_FILES_SUCCEEDED   = QStringLiteral(u"%0 succeeded").arg(X_FILES),
-    SET_COMPLETED_      = QStringLiteral(u"Setting Completed."),
+    READY_              = u"Ready.",
+    X_ENABLED_          = u"%0 enabled.",
+    X_DISABLED_         = u"%0 disabled.",
+    lDONE_              = u"done.",
+    X_FILES_SUCCEEDED   = u"%0 files succeeded",
+    SET_COMPLETED_      = u"Setting Completed.",
 
 //RESULT - ERROR
-    dERROR          = QStringLiteral(u"Error"),
-    ERRORS_WHILE_X  = QStringLiteral(u"%0(s) occurred while %1").arg(dERROR, "%0"),
-    NO_X            = QStringLiteral(u"No %0"),
-    NO_X_X          = NO_X.arg(X_X),
-    lNO_X_SELECTED  = QStringLiteral(u"no %1 %0").arg(lSELECTED),
-
-    WARNING     = QStringLiteral(u"Warning"),
-    lINVALID_X  = QStringLiteral(u"invalid %0"),
-    INVALID_X   = QStringLiteral(u"Invalid %0"),
-    lEXISTS     = QStringLiteral(u"already exists"),
-
-    X_MISSING       = QStringLiteral(u"%0 missing"),
-    MISSING_FILE_X  = QStringLiteral(u"Missing %0").arg(lFILEc_X),
-    NO_FILES_TO_X   = NO_X.arg(QStringLiteral(u"%0 to %1")).arg(lFILES),
-    X_NOT_FOUND     = QStringLiteral(u"%0 not found"),
-    SKIPPING_FILE_X = QStringLiteral(u"--> Skipping %0").arg(lFILEc_X),
-    FILE_NO_ICONS_                = QStringLiteral(u"That %0 contains no icons.").arg(lFILE),
-
-    NO_MOD_X_        = QStringLiteral(u"%0.").arg(NO_X_X).arg(lMOD),
-    MOD_EXISTS_      = QStringLiteral(u"A %0 with that name %1.").arg(lMOD, lEXISTS),
-
-    FAILED_TO_X                   = QStringLiteral(u"Failed to %0"),
-    FAILED_TO_X_                  = QStringLiteral(u"%0.").arg(FAILED_TO_X),
-    FAILED_TO_CREATE_BACKUP_X     = FAILED_TO_X.arg(lCREATE_X).arg(QStringLiteral(u"backup of %0")),
-    FAILED_TO_CREATE_SHORTCUTc_X_ = FAILED_TO_X_.arg(QStringLiteral(u"%0: %1")).arg(lCREATE_X).arg(lSHORTCUT, "%0"),
-    FAILED_TO_OPEN_REGK_          = FAILED_TO_X_.arg(lOPEN_X).arg(QStringLiteral(u"registry key")),
-    FAILED_TO_SET_X_              = FAILED_TO_X_.arg(X_X).arg(lSET, "%0"),
-    FAILED_TO_GET_X_              = FAILED_TO_X_.arg(QStringLiteral(u"get %0")),
-    lFAILED                       = QStringLiteral(u"failed"),
-    X_FAILED                      = X_X.arg("%0", lFAILED),
-    lFINISHED_WITH_ERRORS         = QStringLiteral(u"finished with errors."),
-
-    PLS_REFRESH_ = QStringLiteral(u"Please refresh."),
-    CHARACTERS_NOT_ALLOWED = QStringLiteral(u"The following characters aren't allowed:\n< > : \" / \\ | ? *"),
+    dERROR          = u"Error",
+    ERRORS_WHILE_X  = u"Error(s) occurred while %0",
+    NO_X            = u"No %0",
+    NO_X_X          = u"No %0 %1",
+    lNO_X_SELECTED  = u"no %1 selected",
+
+    WARNING     = u"Warning",
+    lINVALID_X  = u"invalid %0",
+    INVALID_X   = u"Invalid %0",
+    lEXISTS     = u"already exists",
+
+    X_MISSING       = u"%0 missing",
+    MISSING_FILE_X  = u"Missing file: %0",
+    NO_FILES_TO_X   = u"No files to %1",
+    X_NOT_FOUND     = u"%0 not found",
+    SKIPPING_FILE_X = u"--> Skipping file: %0",
+    FILE_NO_ICONS_                = u"That file contains no icons.",
+
+    NO_MOD_X_        = u"No mod %1.",
+    MOD_EXISTS_      = u"A mod with that name already exists.",
+
+    FAILED_TO_X                   = u"Failed to %0",
+    FAILED_TO_X_                  = u"Failed to %0.",
+    FAILED_TO_CREATE_BACKUP_X     = u"Failed to create backup of %0",
+    FAILED_TO_CREATE_SHORTCUTc_X_ = u"Failed to create shortcut: %0.",
+    FAILED_TO_OPEN_REGK_          = u"Failed to open registry key.",
+    FAILED_TO_SET_X_              = u"Failed to set %0.",
+    FAILED_TO_GET_X_              = u"Failed to get %0.",
+    lFAILED                       = u"failed",
+    X_FAILED                      = u"%0 failed",
+    lFINISHED_WITH_ERRORS         = u"finished with errors.",
+
+    PLS_REFRESH_ = u"Please refresh.",
+    CHARACTERS_NOT_ALLOWED = u"The following characters aren't allowed:\n< > : \" / \\ | ? *",
 
 // ACTIONS
     // SCAN
-    SCANNING        = QStringLiteral(u"Scanning"),
-    SCANNING_X___   = QStringLiteral(u"%0 %1...").arg(SCANNING, "%0"),
-    lSCANNING_MODS  = QStringLiteral(u"scanning %0").arg(lMODS),
+    SCANNING        = u"Scanning",
+    SCANNING_X___   = u"Scanning %0...",
+    lSCANNING_MODS  = u"scanning mods",
 
     // MOUNT
-    MOUNTING                  = QStringLiteral(u"Mounting"),
-    lMOUNTING                 = QStringLiteral(u"mounting"),
-    MOUNTING_X___             = QStringLiteral(u"%0 %1...").arg(MOUNTING, "%0"),
-    lMOUNT                    = QStringLiteral(u"mount"),
-    MOUNT                     = QStringLiteral(u"Mount"),
-    MOUNTED                   = QStringLiteral(u"Mounted"),
-    lMOUNTED                  = QStringLiteral(u"mounted"),
-    SELECT_MOD_TO_MOUNT_      = QStringLiteral(u"%0 a %1 to %2.").arg(SELECT, lMOD, lMOUNT),
-    ALREADY_MOUNTEDc_X_       = QStringLiteral(u"Already %0: %1.").arg(lMOUNTED, "%0"),
-    FAILED_TO_FIND_MOUNTED_X_ = FAILED_TO_X_.arg(QStringLiteral(u"find %0 %1: %2")).arg(lMOUNTED, lMOD, "%0"),
-    lCREATE_SYMLINK_TO        = QStringLiteral(u"%0 to").arg(lCREATE_X).arg(lSYMLINK),
+    MOUNTING                  = u"Mounting",
+    lMOUNTING                 = u"mounting",
+    MOUNTING_X___             = u"Mounting %0...",
+    lMOUNT                    = u"mount",
+    MOUNT                     = u"Mount",
+    MOUNTED                   = u"Mounted",
+    lMOUNTED                  = u"mounted",
+    SELECT_MOD_TO_MOUNT_      = u"Select a mod to mount.",
+    ALREADY_MOUNTEDc_X_       = u"Already mounted: %0.",
+    FAILED_TO_FIND_MOUNTED_X_ = u"Failed to find mounted mod: %0.",
+    lCREATE_SYMLINK_TO        = u"create symbolic link to",
+    MOUNT_AS_aOVERLAY         = u"Mount as &Overlay",
+    MOUNT_aLAYERED___         = u"Mount &Layered...",
+    MOUNT_LAYERED             = u"Mount Layered",
+    LAYERS_HINT               = u"Checked mods are stacked; a mod wins over the ones below it.",
+    SELECT_2_MODS_TO_LAYER_   = u"Select at least 2 mods to layer.",
+    lLISTING_FILES___         = u"listing files...",
+    lLINKING_FILES___         = u"linking files...",
 
     // UNMOUNT
-    UNMOUNTING              = QStringLiteral(u"Unmounting"),
-    UNMOUNTING_X___         = QStringLiteral(u"%0 %1...").arg(UNMOUNTING, "%0"),
-    UNMOUNT                 = QStringLiteral(u"Unmount"),
-    lUNMOUNT                = QStringLiteral(u"unmount"),
-    X_NOT_MOUNTED__X        = QStringLiteral(u"%0 is not %1. %2").arg("%0", lMOUNTED, "%1"),
-    NOTHING_UNMOUNT_        = QStringLiteral(u"Nothing to %0.").arg(lUNMOUNT),
-    lUNKNOWN_MOD            = QStringLiteral(u"%0 %1").arg(lUNKNOWN, lMOD),
-
-    NOT_A_SYMLINKc_X        = QStringLiteral(u"Not a %0: %1").arg(lSYMLINK, "%0"),
-    lRESTORING_BACKUPS___   = QStringLiteral(u"restoring backups..."),
-    FORCE_X                 = QStringLiteral(u"Force %0"),
+    UNMOUNTING              = u"Unmounting",
+    UNMOUNTING_X___         = u"Unmounting %0...",
+    UNMOUNT                 = u"Unmount",
+    lUNMOUNT                = u"unmount",
+    X_NOT_MOUNTED__X        = u"%0 is not mounted. %1",
+    NOTHING_UNMOUNT_        = u"Nothing to unmount.",
+    lUNKNOWN_MOD            = u"unknown mod",
+
+    NOT_A_SYMLINKc_X        = u"Not a symbolic link: %0",
+    lRESTORING_BACKUPS___   = u"restoring backups...",
+    lREMOVING_LINKS___      = u"removing links...",
+    FORCE_X                 = u"Force %0",
 
     // ADD
-    ADDING      = QStringLiteral(u"Adding"),
-    ADDING_X___ = QStringLiteral(u"%0 %1...").arg(ADDING, "%0"),
-    ADD_uMOD    = QStringLiteral(u"Add %0").arg(MOD),
-    lADD        = QStringLiteral(u"add"),
+    ADDING      = u"Adding",
+    ADDING_X___ = u"Adding %0...",
+    ADD_uMOD    = u"Add Mod",
+    lADD        = u"add",
 
-    lMOVE       = QStringLiteral(u"move"),
-    MOVE        = QStringLiteral(u"Move"),
-    lCOPY       = QStringLiteral(u"copy"),
-    COPY        = QStringLiteral(u"Copy"),
+    lMOVE       = u"move",
+    MOVE        = u"Move",
+    lCOPY       = u"copy",
+    COPY        = u"Copy",
 
     // DELETE
-    DELETING        = QStringLiteral(u"Deleting"),
-    dDELETE         = QStringLiteral(u"Delete"),
-    DELETING_X___   = QStringLiteral(u"%0 %1...").arg(DELETING),
-    lDELETE         = QStringLiteral(u"delete"),
-    lDELETE_X       = X_X.arg(lDELETE, "%0"),
-    FAILED_TO_DELETE_EMPTY_FOLDERc_X_
-                    = FAILED_TO_X_.arg(QStringLiteral(u"%0: %1")).arg(lDELETE_X).arg(X_FOLDER)
-                                                                 .arg(QStringLiteral(u"empty"), "%0"),
+    DELETING        = u"Deleting",
+    dDELETE         = u"Delete",
+    DELETING_X___   = u"Deleting %1...",
+    lDELETE         = u"delete",
+    lDELETE_X       = u"delete %0",
+    FAILED_TO_DELETE_EMPTY_FOLDERc_X_ = u"Failed to delete empty folder: %0.",
+    FAILED_TO_CREATE_FOLDERc_X = u"Failed to create folder: %0",
 
     // SHORTCUT
-    CREATING_SHORTCUT___ = QStringLiteral(u"Creating %0...").arg(lSHORTCUT),
-    CREATE_uSHORTCUTS    = CREATE_X.arg(QStringLiteral(u"Shortcuts")),
-    SHORTCUT_CREATED_    = SHORTCUT_X.arg(QStringLiteral(u"created.")),
+    CREATING_SHORTCUT___ = u"Creating shortcut...",
+    CREATE_uSHORTCUTS    = u"Create Shortcuts",
+    SHORTCUT_CREATED_    = u"Shortcut created.",
+
+    // BACKUPS
+    CLEAN_UP_uBACKUPS      = u"Clean Up Backups",
+    CLEANING_UP_BACKUPS___ = u"Cleaning up backups...",
+    X_BACKUPS_DELETED_X_   = u"%0 backups deleted (%1 freed).",
+
+    // DEDUPLICATE
+    DEDUPLICATING          = u"Deduplicating",
+    DEDUPLICATE            = u"Deduplicate",
+    lDEDUPLICATE           = u"deduplicate",
+    DEDUPLICATE_ALL_uMODS  = u"Deduplicate All Mods",
+    lALL_MODS              = u"all mods",
+    DEDUP_ADDED_MODS       = u"Deduplicate Added Mods",
+    X_APPARENT_X_UNIQUE    = u"%0 apparent, %1 unique",
+    X_SAVED_BY_LINKS_      = u"%0 saved by linking identical files.",
+    X_FILES_THROUGH_LINKS  = u"%0 files sized through links",
+    X_UNUSED_OBJECTS_DELETED_ = u"%0 unused store files deleted.",
+
+    // VERIFY
+    VERIFYING              = u"Verifying",
+    VERIFY                 = u"Verify",
+    lVERIFY                = u"verify",
+    VERIFY_ALL_uMODS       = u"Verify All Mods",
+    lREAD                  = u"read",
+    CHANGED_FILEc_X        = u"Changed file: %0",
+    ACCEPT_CHANGES_Xq      = u"Accept the changed and missing files of %0 as they are now?",
+
+    // PACK
+    PACKING                = u"Packing",
+    PACK                   = u"Pack",
+    lPACK                  = u"pack",
+    X_TOO_LARGE_TO_PACK    = u"%0 is too large to pack (4 GB at most).",
+
+    // CONFLICTS
+    CONFLICTS              = u"Conflicts",
+    X_CONFLICTS_X_         = u"%0 files of %1 are also provided by other mods or the game folder.",
+    NO_CONFLICTS_X_        = u"No file of %0 is provided anywhere else.",
+    X_ALSO_IN_X            = u"%0  <--  %1",
 
     // LAUNCHING
-    lARGUMENTS              = QStringLiteral(u"arguments"),
-    PROCESSING_ARGUMENTS___ = QStringLiteral(u"%0...").arg(X_X).arg(PROCESSING, lARGUMENTS),
+    lARGUMENTS              = u"arguments",
+    PROCESSING_ARGUMENTS___ = u"Processing arguments...",
 
     // RENAME
-    RENAME              = QStringLiteral(u"Rename"),
-    lRENAME             = QStringLiteral(u"rename"),
-    X_RENAMED_X_        = QStringLiteral(u"%0 renamed to %1."),
+    RENAME              = u"Rename",
+    lRENAME             = u"rename",
+    X_RENAMED_X_        = u"%0 renamed to %1.",
 
-    ABORT           = QStringLiteral(u"Abort"),
-    lABORTED        = QStringLiteral(u"aborted"),
-    X_ABORTED       = X_X.arg("%0", lABORTED),
-    INVALID_ACTION_ = INVALID_X.arg(QStringLiteral(u"action.")),
-    X_BUSY          = QStringLiteral(u"%0 is busy. Try again later."),
-    CANT_X_MOUNTED_ = QStringLiteral(u"Can't %0 a %1 while %2.").arg("%0", lMOD, lMOUNTED),
+    ABORT           = u"Abort",
+    lABORTED        = u"aborted",
+    X_ABORTED       = u"%0 aborted",
+    INVALID_ACTION_ = u"Invalid action.",
+    X_BUSY          = u"%0 is busy. Try again later.",
+    CANT_X_MOUNTED_ = u"Can't %0 a mod while mounted.",
 
 //DIALOGS
     // MAIN INIT
-    STARTING___  = QStringLiteral(u"Starting..."),
-    SETUP_UI___         = QStringLiteral(u"Setting up UI..."),
-    EXITING___   = QStringLiteral(u"Exiting..."),
+    STARTING___  = u"Starting...",
+    SETUP_UI___         = u"Setting up UI...",
+    EXITING___   = u"Exiting...",
     // MAINWINDOW
-    REFRESHING___ = QStringLiteral(u"Refreshing..."),
-    REFRESHED_    = QStringLiteral(u"%0 refreshed.").arg(WC3MM),
-    X_cTOOLBAR    = QStringLiteral(u"%0 Toolbar"),
-    GAME_cTOOLBAR = X_cTOOLBAR.arg(GAME),
-    MODS_cTOOLBAR = X_cTOOLBAR.arg(MODS),
-    ALLOW_FILES   = QStringLiteral(u"Allow Local Files"),
-    GAME_VERSION  = QStringLiteral(u"Preferred Game Version"),
+    REFRESHING___ = u"Refreshing...",
+    REFRESHED_    = u"WC3 Mod Manager refreshed.",
+    X_cTOOLBAR    = u"%0 Toolbar",
+    GAME_cTOOLBAR = u"Game Toolbar",
+    MODS_cTOOLBAR = u"Mods Toolbar",
+    ALLOW_FILES   = u"Allow Local Files",
+    GAME_VERSION  = u"Preferred Game Version",
     // SETTINGS
-    SETTINGS           = QStringLiteral(u"Settings"),
-    SAVING_SETTINGS___ = QStringLiteral(u"Saving settings..."),
-    SETTINGS_SAVED_    = QStringLiteral(u"%0 saved.").arg(SETTINGS),
-    BROWSE___          = QStringLiteral(u"Browse..."),
-    HIDE_EMPTY         = QStringLiteral(u"Hide Empty %0").arg(MODS),
+    SETTINGS           = u"Settings",
+    SAVING_SETTINGS___ = u"Saving settings...",
+    SETTINGS_SAVED_    = u"Settings saved.",
+    BROWSE___          = u"Browse...",
+    HIDE_EMPTY         = u"Hide Empty Mods",
     // CREATE SHORTCUT
-    DONT_SET            = QStringLiteral(u"Don't Set"),
-    WC3_CMD_GUIDE       = QStringLiteral(u"%0 Command Line Arguments Guide").arg(WC3),
-    SHORTCUT_uNAMEc     = SHORTCUT_X.arg(QStringLiteral(u"Name:")),
-    SHORTCUT_uICONc     = SHORTCUT_X.arg(QStringLiteral(u"Icon:")),
+    DONT_SET            = u"Don't Set",
+    WC3_CMD_GUIDE       = u"Warcraft III Command Line Arguments Guide",
+    SHORTCUT_uNAMEc     = u"Shortcut Name:",
+    SHORTCUT_uICONc     = u"Shortcut Icon:",
     //ABOUT
-    ABOUT     = QStringLiteral(u"About"),
-    DOWNLOADc = QStringLiteral(u"Download:"),
-    SOURCEc   = QStringLiteral(u"Source:"),
-    LICENSEc  = QStringLiteral(u"License:"),
+    ABOUT     = u"About",
+    DOWNLOADc = u"Download:",
+    SOURCEc   = u"Source:",
+    LICENSEc  = u"License:",
 
     //QUESTIONS
-    lYOU_WANT_TO_Xq             = QStringLiteral(u"you want to %0?"),
-    DO_WANT_TO_Xq               = QStringLiteral(u"Do %0").arg(lYOU_WANT_TO_Xq),
-    CONTINUE_LAUNCHING_GAMEq    = DO_WANT_TO_Xq.arg(QStringLiteral(u"continue %0"))
-                                               .arg(lLAUNCHING_X).arg(QStringLiteral(u"the %0")).arg(lGAME),
-    ARE_YOU_SURE_Xq             = QStringLiteral(u"Are you sure %0").arg(lYOU_WANT_TO_Xq),
+    lYOU_WANT_TO_Xq             = u"you want to %0?",
+    DO_WANT_TO_Xq               = u"Do you want to %0?",
+    CONTINUE_LAUNCHING_GAMEq    = u"Do you want to continue launching the game?",
+    ARE_YOU_SURE_Xq             = u"Are you sure you want to %0?",
 
         //ADD MOD
-    COPY_MOVEq          = QStringLiteral(u"%0 or %1?").arg(COPY, lMOVE),
-    COPY_MOVE_LONGq     = DO_WANT_TO_Xq.arg(QStringLiteral(u"%0 or %1 %2"))
-                                       .arg(lCOPY, lMOVE, X_FOLDER.arg(QStringLiteral(u"this"))),
+    COPY_MOVEq          = u"Copy or move?",
+    COPY_MOVE_LONGq     = u"Do you want to copy or move this folder?",
         //DELETE MOD
-    PERM_DELETE_Xq      = QStringLiteral(u"Permanently %0?").arg(lDELETE_X),
-    PERM_DELETE_X_LONGq = QStringLiteral(u"%0 (%1 / %2)")
-                            .arg(ARE_YOU_SURE_Xq).arg(QStringLiteral(u"PERMANENTLY %0")).arg(lDELETE_X),
+    PERM_DELETE_Xq      = u"Permanently delete %0?",
+    PERM_DELETE_X_LONGq = u"Are you sure you want to PERMANENTLY delete %0? (%1 / %2)",
 
     //UI STRINGS WITH ALT &SHORTCUT
-    aX = QStringLiteral(u"&%0"),
+    aX = u"&%0",
 
         //MAIN WINDOW
-    aFILE               = QStringLiteral(u"&File"),
-    aTOOLS              = QStringLiteral(u"&Tools"),
-    aHELP               = QStringLiteral(u"&Help"),
-    ALLOW_aLOCAL_FILES  = QString(ALLOW_FILES).insert(ALLOW_FILES.indexOf('L'), '&'),
-    UNaMOUNT            = QString(UNMOUNT).insert(UNMOUNT.indexOf('m'), '&'),
-    aREFRESH            = QStringLiteral(u"&Refresh");
+    aFILE               = u"&File",
+    aTOOLS              = u"&Tools",
+    aHELP               = u"&Help",
+    ALLOW_aLOCAL_FILES  = u"Allow &Local Files",
+    UNaMOUNT            = u"Un&mount",
+    aREFRESH            = u"&Refresh";
 
     enum class Ac
-         { PROCESSED,                    X_PROCESSED,                                 lPROCESS, lPROCESS_X, Ac_Size };
-
-    typedef std::array<const QString, size_t(Ac::Ac_Size)> ac_t;
-
-    static const std::unordered_map<QString, const ac_t > ac
-    ({ { MOUNTING,
-         { MOUNTED,                      X_X.arg("%0", lMOUNTED),                     lMOUNT,   X_X.arg(lMOUNT, "%0") } },
-       { UNMOUNTING,
-         { QStringLiteral(u"Unmounted"), X_X.arg("%0", QStringLiteral(u"unmounted")), lUNMOUNT, X_X.arg(lUNMOUNT, "%0") } },
-       { ADDING,
-         { QStringLiteral(u"Added"),     X_X.arg("%0", QStringLiteral(u"added")),     lADD,     X_X.arg(lADD, "%0") } },
-       { DELETING,
-         { QStringLiteral(u"Deleted"),   X_X.arg("%0", QStringLiteral(u"deleted")),   lDELETE,  lDELETE_X } } });
+         { PROCESSING, PROCESSED, X_PROCESSED, lPROCESS, lPROCESS_X, Ac_Size };
+
+    typedef std::array<Str, size_t(Ac::Ac_Size)> ac_t;
+
+    inline constexpr ac_t acOther
+         { PROCESSING,    u"Processed",    u"%0 processed",    u"process",    u"process %0" };
+
+    inline constexpr std::array<ac_t, ThreadAction::Action_Size> ac // by ThreadAction::Action
+    {{ /* NoAction */ acOther,
+       /* Mount    */ ac_t{ MOUNTING,      MOUNTED,          u"%0 mounted",      lMOUNT,       u"mount %0" },
+       /* Unmount  */ ac_t{ UNMOUNTING,    u"Unmounted",     u"%0 unmounted",    lUNMOUNT,     u"unmount %0" },
+       /* ModData  */ acOther,
+       /* Add      */ ac_t{ ADDING,        u"Added",         u"%0 added",        lADD,         u"add %0" },
+       /* Delete   */ ac_t{ DELETING,      u"Deleted",       u"%0 deleted",      lDELETE,      lDELETE_X },
+       /* Shortcut */ acOther,
+       /* Dedup    */ ac_t{ DEDUPLICATING, u"Deduplicated",  u"%0 deduplicated", lDEDUPLICATE, u"deduplicate %0" },
+       /* Verify   */ ac_t{ VERIFYING,     u"Verified",      u"%0 verified",     lVERIFY,      u"verify %0" },
+       /* Pack     */ ac_t{ PACKING,       u"Packed",        u"%0 packed",       lPACK,        u"pack %0" } }};
+    static_assert(ThreadAction::Pack+1 == ThreadAction::Action_Size, "d::ac: one row per ThreadAction::Action");
 }
 
 #endif // DIC_H
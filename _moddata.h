@@ -2,30 +2,222 @@
 #define MODDATA_H
 
 #include "_uo_map_qs.h"
+#include <QStringList>
+#include <vector>
 
 namespace md {
 const QString unknownMod = "<unknown>",
               w3mod      = "war3mod.mpq",
               w3modX     = "war3mod_%0.mpq";
 
-enum ModData       { Row, Busy, Size };
-typedef std::tuple < int, bool, qint64 > data;
-typedef std::unordered_map<QString, data> modData;
+/* Identity of a mod folder as seen by the last refresh: NTFS file id (survives renames, 0 if unknown)
+ * and mtime of the mod folder itself (changes when an entry directly inside it is added, removed or renamed) */
+struct Stamp {
+    quint64 id    = 0;
+    qint64  mtime = 0;
 
-inline data newData(const int row, const bool busy=true)
-{ return { row, busy, 0 }; }
+    bool operator==(const Stamp &other) const { return id == other.id && mtime == other.mtime; }
+    bool operator!=(const Stamp &other) const { return !(*this == other); }
+};
 
-inline void setRow(data &data, const int row)
-{ std::get<int(md::Row)>(data) = row; }
+/* Mod list storage: one slot per mod in flat parallel arrays plus one name -> slot hash.
+ * Rows map to slots through `order`, so inserting or removing a row only moves ints;
+ * slots never move, and slot -> row is rebuilt in a single pass the next time a row is looked up. */
+class Registry
+{
+         enum Flag : quint8 { Busy = 1 };
 
-inline bool exists(const modData &modData, const QString &modName)
-{ return modData.find(modName) != modData.end(); }
+         std::vector<QString> names;
+         std::vector<qint64>  sizes;
+         std::vector<int>     fileCounts;
+         std::vector<int>     links;      // files sized through links
+         std::vector<quint8>  flags;
+         std::vector<Stamp>   stamps;
+         std::vector<int>     freeSlots;
 
-inline bool busy(const data &data)
-{ return std::get<int(md::Busy)>(data); }
+         std::vector<int>         order;    // row -> slot
+         mutable std::vector<int> rows;     // slot -> row, valid while !rowsDirty
+         mutable bool             rowsDirty = false;
 
-inline qint64 size(const data &data)
-{ return std::get<int(md::Size)>(data); }
+         std::unordered_map<QString, int> slots;
+
+         int slot(const QString &name) const
+         {
+             const auto it = slots.find(name);
+             return it == slots.end() ? -1 : it->second;
+         }
+
+         int rowOf(const int slot) const
+         {
+             if(rowsDirty)
+             {
+                 for(int row=0; row < int(order.size()); ++row) rows[size_t(order[size_t(row)])] = row;
+                 rowsDirty = false;
+             }
+             return rows[size_t(slot)];
+         }
+
+         void setFlag(const int slot, const Flag flag, const bool on)
+         { flags[size_t(slot)] = quint8(on ? flags[size_t(slot)]|flag : flags[size_t(slot)]&~flag); }
+
+public:  int  count() const { return int(order.size()); }
+         bool contains(const QString &name) const { return slots.find(name) != slots.end(); }
+
+         int row(const QString &name) const
+         {
+             const int slot = this->slot(name);
+             return slot < 0 ? -1 : rowOf(slot);
+         }
+
+         const QString &name     (const int row) const { return names     [size_t(order[size_t(row)])]; }
+         qint64         size     (const int row) const { return sizes     [size_t(order[size_t(row)])]; }
+         int            fileCount(const int row) const { return fileCounts[size_t(order[size_t(row)])]; }
+         int            linkCount(const int row) const { return links     [size_t(order[size_t(row)])]; }
+         bool           busy     (const int row) const { return flags     [size_t(order[size_t(row)])] & Busy; }
+         const Stamp   &stamp    (const int row) const { return stamps    [size_t(order[size_t(row)])]; }
+
+         bool isBusy(const QString &name) const
+         {
+             const int slot = this->slot(name);
+             return slot >= 0 && flags[size_t(slot)] & Busy;
+         }
+
+         void reserve(const int count)
+         {
+             names.reserve(size_t(count)); sizes.reserve(size_t(count));
+             fileCounts.reserve(size_t(count)); links.reserve(size_t(count)); flags.reserve(size_t(count)); stamps.reserve(size_t(count));
+             order.reserve(size_t(count)); rows.reserve(size_t(count));
+             slots.reserve(size_t(count));
+         }
+
+         void clear()
+         {
+             names.clear(); sizes.clear(); fileCounts.clear(); links.clear(); flags.clear(); stamps.clear(); freeSlots.clear();
+             order.clear(); rows.clear(); slots.clear();
+             rowsDirty = false;
+         }
+
+         void insert(const QString &name, const int row, const bool busy=true)
+         {
+             int slot;
+             if(freeSlots.empty())
+             {
+                 slot = int(names.size());
+                 names.push_back(name);
+                 sizes.push_back(0);
+                 fileCounts.push_back(0);
+                 links.push_back(0);
+                 flags.push_back(busy ? Busy : 0);
+                 stamps.push_back(Stamp());
+                 rows.push_back(row);
+             }
+             else
+             {
+                 slot = freeSlots.back();
+                 freeSlots.pop_back();
+                 names[size_t(slot)] = name;
+                 sizes[size_t(slot)] = 0;
+                 fileCounts[size_t(slot)] = 0;
+                 links[size_t(slot)] = 0;
+                 flags[size_t(slot)] = busy ? Busy : 0;
+                 stamps[size_t(slot)] = Stamp();
+             }
+
+             order.insert(order.begin()+row, slot);
+             slots[name] = slot;
+
+             if(row == count()-1 && !rowsDirty) rows[size_t(slot)] = row; // appended: nothing else moved
+             else rowsDirty = true;
+         }
+
+         void append(const QString &name, const bool busy=true)
+         { insert(name, count(), busy); }
+
+         void move(const int from, const int to) // `to`: the row it ends up at
+         {
+             const int slot = order[size_t(from)];
+             order.erase(order.begin()+from);
+             order.insert(order.begin()+to, slot);
+             rowsDirty = true;
+         }
+
+         // Where `name` goes among rows [first, count()) in listing order (case-insensitive, as NTFS lists), `skip` aside
+         int sortedRow(const QString &name, const int first=0, const int skip=-1) const
+         {
+             int row = first;
+             for(int i=first; i < count(); ++i)
+                 if(i != skip && QString::compare(this->name(i), name, Qt::CaseInsensitive) < 0) ++row;
+             return row;
+         }
+
+         bool remove(const QString &name)
+         {
+             const auto it = slots.find(name);
+             if(it == slots.end()) return false;
+
+             const int slot = it->second, row = rowOf(slot);
+             order.erase(order.begin()+row);
+             slots.erase(it);
+             names[size_t(slot)].clear();
+             freeSlots.push_back(slot);
+
+             if(row != count()) rowsDirty = true;
+             return true;
+         }
+
+         bool rename(const QString &name, const QString &newName)
+         {
+             auto it = slots.find(name);
+             if(it == slots.end() || contains(newName)) return false;
+
+             auto node = slots.extract(it);
+             node.key() = newName;
+             names[size_t(node.mapped())] = newName;
+             slots.insert(std::move(node));
+             return true;
+         }
+
+         int update(const QString &name, const qint64 size, const int fileCount, const int links=0)
+         {
+             const int slot = this->slot(name);
+             if(slot < 0) return -1;
+
+             sizes[size_t(slot)] = size;
+             fileCounts[size_t(slot)] = fileCount;
+             this->links[size_t(slot)] = links;
+             return rowOf(slot);
+         }
+
+         void setBusy(const QString &name, const bool busy)
+         {
+             const int slot = this->slot(name);
+             if(slot >= 0) setFlag(slot, Busy, busy);
+         }
+
+         void setStamp(const QString &name, const Stamp &stamp)
+         {
+             const int slot = this->slot(name);
+             if(slot >= 0) stamps[size_t(slot)] = stamp;
+         }
+};
+
+/* Result of ThreadAction::ModData: how the mods folder differs from the Registry it was given.
+ * Applied in order: removed, renamed (moved to its sorted row), added (in name order), changed (new stamp only:
+ * every listed mod is rescanned on refresh) */
+struct Diff {
+    struct Entry {
+        QString name;
+        int     row = 0;
+        Stamp   stamp;
+    };
+
+    QStringList removed;
+    std::vector<std::pair<QString, Entry> > renamed; // old name -> new entry
+    std::vector<Entry> added, changed;
+    int unchanged = 0;
+
+    bool empty() const { return removed.isEmpty() && renamed.empty() && added.empty() && changed.empty(); }
+};
 }
 
 #endif // MODDATA_H
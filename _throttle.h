@@ -0,0 +1,46 @@
+#ifndef THROTTLE_H
+#define THROTTLE_H
+
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+
+/* Coalesces progress updates: ready() is true at most once per `ms`,
+ * or sooner once `count` updates have piled up (count 0: time budget only).
+ * Safe to share between threads; the caller that gets `true` emits the current totals. */
+class Throttle
+{
+         static inline QAtomicInt defaultMs = 50, defaultCount = 0;
+
+         const int ms, count;
+         QElapsedTimer          clock;
+         QAtomicInteger<qint64> last;
+         QAtomicInt             pending = 0;
+
+public:  Throttle() : Throttle(defaultMs.loadAcquire(), defaultCount.loadAcquire()) {}
+         Throttle(const int ms, const int count) : ms(std::max(ms, 0)), count(std::max(count, 0)), last(-ms)
+         { clock.start(); }
+
+         static void setDefaults(const int ms, const int count)
+         {
+             defaultMs.storeRelease(ms);
+             defaultCount.storeRelease(count);
+         }
+
+         bool ready(const int amount=1)
+         {
+             const int    piled = pending.fetchAndAddRelaxed(amount)+amount;
+             const qint64 now = clock.elapsed(), prev = last.loadAcquire();
+
+             if(now-prev >= ms || (count > 0 && piled >= count))
+             {
+                 if(last.testAndSetOrdered(prev, now))
+                 {
+                     pending.storeRelease(0);
+                     return true;
+                 }
+             }
+             return false;
+         }
+};
+
+#endif // THROTTLE_H
@@ -0,0 +1,37 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <vector>
+
+/* Startup timeline: mark() records the ms since start() at the end of each phase, save() writes them to
+ * startup.log next to the exe, one "<ms> <phase>" line each (the previous run's log is replaced).
+ * GUI thread only; marks after save() are dropped, so only startup is ever timed. */
+class Timeline
+{
+         static inline QElapsedTimer clock;
+         static inline std::vector<std::pair<qint64, const char *> > marks;
+         static inline bool saved = false;
+
+public:  static void start() { clock.start(); }
+
+         static void mark(const char *phase)
+         { if(!saved && clock.isValid()) marks.push_back({ clock.elapsed(), phase }); }
+
+         static void save()
+         {
+             if(saved || !clock.isValid()) return;
+             saved = true;
+
+             QByteArray log;
+             for(const std::pair<qint64, const char *> &mark : marks)
+                 log += QByteArray::number(mark.first).rightJustified(6)+" "+mark.second+"\n";
+
+             QSaveFile file(QCoreApplication::applicationDirPath()+"/startup.log");
+             if(file.open(QIODevice::WriteOnly) && file.write(log) == log.size()) file.commit();
+         }
+};
+
+#endif // TIMELINE_H
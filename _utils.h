@@ -13,6 +13,12 @@ inline QIcon largestIcon(const QIcon &icon)
     return icon.pixmap(max);
 }
 
+inline const QIcon &lazyIcon(QIcon &icon, const QString &path) // decoded on first use
+{
+    if(icon.isNull()) icon = largestIcon(QIcon(path));
+    return icon;
+}
+
 inline bool isValidFileName(const QString &fileName)
 {
     return !fileName.contains('<') && !fileName.contains('>') && !fileName.contains(':')
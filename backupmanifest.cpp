@@ -0,0 +1,229 @@
+#include "backupmanifest.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <algorithm>
+
+const quint32 BackupManifest::MAGIC   = 0x574d4d42, // "WMMB"
+              BackupManifest::VERSION = 1;
+
+QString BackupManifest::sharedPath;
+
+BackupManifest::BackupManifest(const QString &path) : path(path)
+{ load(); }
+
+BackupManifest &BackupManifest::shared()
+{
+    static BackupManifest manifest(sharedPath.isEmpty() ? QCoreApplication::applicationDirPath()+"/backups.idx"
+                                                        : sharedPath);
+    return manifest;
+}
+
+QString BackupManifest::allocate(const QString &pattern, quint32 &seq)
+{
+    QMutexLocker lock(&mutex);
+
+    quint32 &next = nextSeq[pattern];
+    for(next = std::max(next, 1u); ; ++next)
+    {
+        const QString &backup = pattern.arg(next == 1 ? QString() : QString::number(next));
+        if(entries.find(backup) != entries.end()) continue;
+
+        const QFileInfo fiBackup(backup); // taken by something the manifest doesn't know about (older backups)
+        if(fiBackup.isSymLink() || fiBackup.exists()) continue;
+
+        seq = next++;
+        dirty = true;
+        return backup;
+    }
+}
+
+void BackupManifest::record(const QString &original, const QString &backup, const quint32 seq, const bool restore)
+{
+    Entry entry;
+    entry.original = original;
+    entry.backup   = backup;
+    entry.seq      = seq;
+    entry.time     = QDateTime::currentMSecsSinceEpoch();
+    entry.size     = measure(backup);
+    entry.restore  = restore;
+
+    QMutexLocker lock(&mutex);
+    entries[backup] = std::move(entry);
+    dirty = true;
+}
+
+void BackupManifest::forget(const QString &backup)
+{
+    QMutexLocker lock(&mutex);
+    if(entries.erase(backup)) dirty = true;
+}
+
+void BackupManifest::release(const QString &backup)
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = entries.find(backup);
+    if(it != entries.end() && it->second.restore)
+    {
+        it->second.restore = false;
+        dirty = true;
+    }
+}
+
+std::vector<BackupManifest::Entry> BackupManifest::restorable() const
+{
+    std::vector<Entry> result;
+    {
+        QMutexLocker lock(&mutex);
+        for(const std::pair<const QString, Entry> &entry : entries)
+            if(entry.second.restore) result.push_back(entry.second);
+    }
+
+    std::sort(result.begin(), result.end(), [](const Entry &a, const Entry &b) {
+        return a.time != b.time ? a.time < b.time : a.seq < b.seq;
+    });
+    return result;
+}
+
+BackupManifest::Freed BackupManifest::gc(const qint64 maxAgeMs, const qint64 maxSize)
+{
+    std::vector<Entry> candidates;
+    {
+        QMutexLocker lock(&mutex);
+        for(const std::pair<const QString, Entry> &entry : entries)
+            if(!entry.second.restore) candidates.push_back(entry.second);
+    }
+
+    // Backups deleted by hand don't count towards the total
+    qint64 total = 0;
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const Entry &entry) {
+        const QFileInfo fiBackup(entry.backup);
+        if(fiBackup.isSymLink() || fiBackup.exists())
+        {
+            total += entry.size;
+            return false;
+        }
+        forget(entry.backup);
+        return true;
+    }), candidates.end());
+
+    std::sort(candidates.begin(), candidates.end(), [](const Entry &a, const Entry &b) { return a.time < b.time; });
+
+    // Oldest first: everything past maxAgeMs, then whatever keeps the total above maxSize
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    Freed freed;
+    for(const Entry &entry : candidates)
+    {
+        if(!(maxAgeMs > 0 && now-entry.time > maxAgeMs) && !(maxSize > 0 && total > maxSize)) break;
+
+        if(remove(entry.backup))
+        {
+            forget(entry.backup);
+            total -= entry.size;
+            ++freed.count;
+            freed.size += entry.size;
+        }
+    }
+
+    save();
+    return freed;
+}
+
+qint64 BackupManifest::measure(const QString &path)
+{
+    const QFileInfo fi(path);
+    if(fi.isSymLink()) return 0;
+    if(!fi.isDir()) return fi.size();
+
+    qint64 size = 0;
+    for(QDirIterator it(path, QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories); it.hasNext(); )
+    {
+        it.next();
+        if(!it.fileInfo().isSymLink()) size += it.fileInfo().size();
+    }
+    return size;
+}
+
+bool BackupManifest::remove(const QString &path)
+{
+    const QFileInfo fi(path);
+    if(fi.isSymLink()) return QFile::remove(path) || QDir().rmdir(path); // never follow a link into its target
+    if(fi.isDir()) return QDir(path).removeRecursively();
+    return QFile::remove(path);
+}
+
+void BackupManifest::load()
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    quint32 magic, version, entryCount, seqCount;
+    in >> magic >> version >> entryCount;
+    if(magic != MAGIC || version != VERSION) return;
+
+    std::unordered_map<QString, Entry> loaded;
+    for(quint32 i=0; i < entryCount && in.status() == QDataStream::Ok; ++i)
+    {
+        Entry entry;
+        in >> entry.original >> entry.backup >> entry.seq >> entry.time >> entry.size >> entry.restore;
+        loaded.insert({ entry.backup, std::move(entry) });
+    }
+
+    std::unordered_map<QString, quint32> loadedSeq;
+    in >> seqCount;
+    for(quint32 i=0; i < seqCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString pattern;
+        quint32 next;
+        in >> pattern >> next;
+        loadedSeq.insert({ pattern, next });
+    }
+
+    if(in.status() == QDataStream::Ok)
+    {
+        QMutexLocker lock(&mutex);
+        entries = std::move(loaded);
+        nextSeq = std::move(loadedSeq);
+        dirty = false;
+    }
+}
+
+bool BackupManifest::save()
+{
+    std::unordered_map<QString, Entry>   entriesSnapshot;
+    std::unordered_map<QString, quint32> seqSnapshot;
+    {
+        QMutexLocker lock(&mutex);
+        if(!dirty) return true;
+        entriesSnapshot = entries;
+        seqSnapshot = nextSeq;
+        dirty = false;
+    }
+
+    QSaveFile file(path);
+    if(file.open(QIODevice::WriteOnly))
+    {
+        QDataStream out(&file);
+        out << MAGIC << VERSION << quint32(entriesSnapshot.size());
+        for(const std::pair<const QString, Entry> &entry : entriesSnapshot)
+            out << entry.second.original << entry.second.backup << entry.second.seq
+                << entry.second.time << entry.second.size << entry.second.restore;
+
+        out << quint32(seqSnapshot.size());
+        for(const std::pair<const QString, quint32> &next : seqSnapshot) out << next.first << next.second;
+
+        if(file.commit()) return true;
+    }
+
+    QMutexLocker lock(&mutex);
+    dirty = true;
+    return false;
+}
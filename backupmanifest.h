@@ -0,0 +1,56 @@
+#ifndef BACKUPMANIFEST_H
+#define BACKUPMANIFEST_H
+
+#include "_uo_map_qs.h"
+#include <QMutex>
+#include <vector>
+
+/* Every backup ThreadWorker makes (files replaced by Add or a mount, war3mod.mpq moved aside by Unmount),
+ * kept in one binary file: original path, backup path, sequence number, time and size.
+ * Names come from a per-pattern counter instead of probing .wmmbackup, .wmmbackup2, ... until one is free;
+ * the chosen name is still checked once, so backups made before the manifest existed are never overwritten. */
+class BackupManifest
+{
+public:  struct Entry {
+             QString original, backup;
+             quint32 seq     = 0;
+             qint64  time    = 0;     // ms since epoch
+             qint64  size    = 0;     // bytes freed by deleting it (0 for links)
+             bool    restore = false; // made while mounting: put back by restoreBackups()
+         };
+         struct Freed {
+             int    count = 0;
+             qint64 size  = 0;
+         };
+
+private: static const quint32 MAGIC, VERSION;
+         static QString sharedPath;
+
+         const QString  path;
+         mutable QMutex mutex;
+         std::unordered_map<QString, Entry>   entries; // backup path -> entry
+         std::unordered_map<QString, quint32> nextSeq; // pattern -> next sequence number
+         bool dirty = false;
+
+         void load();
+         static qint64 measure(const QString &path);
+         static bool   remove (const QString &path);
+
+public:  explicit BackupManifest(const QString &path);
+         ~BackupManifest() { save(); }
+
+         static void setPath(const QString &path) { sharedPath = path; } // before the first shared()
+         static BackupManifest &shared();
+
+         // pattern: backup path with %0 where the sequence number goes (nothing for the first one)
+         QString allocate(const QString &pattern, quint32 &seq);
+         void    record  (const QString &original, const QString &backup, const quint32 seq, const bool restore);
+         void    forget  (const QString &backup);
+         void    release (const QString &backup); // no longer restorable: left to gc()
+
+         std::vector<Entry> restorable() const; // oldest first: the first backup of a path is the original
+         Freed gc(const qint64 maxAgeMs, const qint64 maxSize); // restorable backups are kept; 0: no limit
+         bool  save();
+};
+
+#endif // BACKUPMANIFEST_H
@@ -0,0 +1,50 @@
+QT       += core gui widgets
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = bench_actions
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+LIBS        += -lpsapi
+
+SOURCES += \
+    main.cpp \
+    ../../thread.cpp \
+    ../../scanengine.cpp \
+    ../../modindex.cpp \
+    ../../dirlister.cpp \
+    ../../copyengine.cpp \
+    ../../reaper.cpp \
+    ../../backupmanifest.cpp \
+    ../../overlay.cpp \
+    ../../modstore.cpp \
+    ../../modmanifest.cpp \
+    ../../hashengine.cpp \
+    ../../mpqarchive.cpp \
+    ../../mpqwriter.cpp \
+    ../../conflictindex.cpp \
+    ../../layerstack.cpp
+
+HEADERS += \
+    ../../_dic.h \
+    ../../_msgr.h \
+    ../../_moddata.h \
+    ../../_throttle.h \
+    ../../threadbase.h \
+    ../../thread.h \
+    ../../thread_pvt.h \
+    ../../scanengine.h \
+    ../../modindex.h \
+    ../../dirlister.h \
+    ../../copyengine.h \
+    ../../reaper.h \
+    ../../backupmanifest.h \
+    ../../overlay.h \
+    ../../modstore.h \
+    ../../modmanifest.h \
+    ../../hashengine.h \
+    ../../mpqarchive.h \
+    ../../mpqwriter.h \
+    ../../conflictindex.h \
+    ../../layerstack.h
@@ -0,0 +1,322 @@
+/* Times every file ThreadAction on synthetic mod trees by driving ThreadWorker directly
+ * (same thread, no ProgressDiag), and prints one JSON object per line:
+ *   {"bench":"actions","layout":...,"action":...,"run":...,"ok":...,"files":...,"bytes":...,"ms":...,
+ *    "files_per_s":...,"mb_per_s":...,"peak_rss_kb":...}
+ * peak_rss_kb is the peak working set of the whole process so far (Windows has no per-interval peak).
+ *
+ * Layouts: small (many small files), huge (a few large files), deep (long folder chain),
+ *          links (file symlinks; skipped when the account may not create symlinks).
+ * Mount and Unmount also run as overlay (mount_overlay/unmount_overlay), which spreads its link batches over all cores.
+ * dedup hashes every file of the mod into the work folder's own mods/.store.
+ * verify hashes the whole mod (no manifest yet), verify_again only stats it (size and mtime unchanged).
+ * scan_indexed_cold, scan_indexed_warm and scan_full size the mod through ScanEngine, the app's only scanner:
+ * with an empty index, with the index the cold scan left, and without one. ok means every file was counted.
+ * pack compresses the mod into mods/<mod>.mpq, scan_packed sizes that archive from its tables, mount_packed links it.
+ * mount_layered stacks a one-file patch mod over the mod and builds the link farm, mount_layered_again reuses it.
+ *
+ * bench_actions [--layouts small,huge,deep,links] [--small-files N] [--huge-mb N] [--runs N] [--root PATH] [--keep] */
+#define WINVER _WIN32_WINNT_WIN7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "thread_pvt.h"
+#include "scanengine.h"
+#include "backupmanifest.h"
+#include "modstore.h"
+#include "modmanifest.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+
+#include <windows.h>
+#include <psapi.h>
+#include <cstdio>
+
+#ifndef SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE
+    #define SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE 0x2 // Windows 10 1703+, developer mode
+#endif
+
+struct Tree { qint64 files = 0, bytes = 0; bool ok = true; };
+
+static bool writeFile(const QString &path, const qint64 size)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    if(size > 1024*1024) return file.resize(size); // large files: allocate, don't stream
+    return file.write(QByteArray(int(size), 'x')) == size;
+}
+
+static bool makeLink(const QString &link, const QString &target)
+{
+    return CreateSymbolicLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(link).utf16()),
+                               reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(target).utf16()),
+                               SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE);
+}
+
+static Tree generate(const QString &layout, const QString &path, const QCommandLineParser &args)
+{
+    Tree tree;
+    QDir().mkpath(path);
+
+    auto add = [&tree](const QString &file, const qint64 size) {
+        if(writeFile(file, size)) { ++tree.files; tree.bytes += size; }
+        else tree.ok = false;
+    };
+
+    if(layout == "small")
+    {
+        const int files = args.value("small-files").toInt();
+        for(int i=0; i < files; ++i)
+        {
+            const QString &dir = QString("%0/d%1").arg(path).arg(i/100);
+            if(i % 100 == 0) QDir().mkpath(dir);
+            add(QString("%0/f%1.mdx").arg(dir).arg(i), 1024);
+        }
+    }
+    else if(layout == "huge")
+    {
+        const qint64 size = args.value("huge-mb").toLongLong()*1024*1024;
+        for(int i=0; i < 4; ++i) add(QString("%0/huge%1.mpq").arg(path).arg(i), size);
+    }
+    else if(layout == "deep")
+    {
+        QString dir = path;
+        for(int depth=0; depth < 100; ++depth)
+        {
+            dir += "/l"+QString::number(depth);
+            QDir().mkpath(dir);
+            for(int i=0; i < 10; ++i) add(QString("%0/f%1.blp").arg(dir).arg(i), 4096);
+        }
+    }
+    else if(layout == "links")
+    {
+        const QString &targets = path+"_targets";
+        QDir().mkpath(targets);
+        for(int i=0; i < 10000 && tree.ok; ++i)
+        {
+            const QString &target = QString("%0/t%1.mdx").arg(targets).arg(i % 100);
+            if(i < 100 && !writeFile(target, 64*1024)) tree.ok = false;
+            else if(makeLink(QString("%0/f%1.mdx").arg(path).arg(i), target))
+            {
+                ++tree.files;
+                tree.bytes += 64*1024;
+            }
+            else tree.ok = false;
+        }
+    }
+    else tree.ok = false;
+
+    return tree;
+}
+
+static qint64 peakRssKB()
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? qint64(pmc.PeakWorkingSetSize/1024) : -1;
+}
+
+/* Runs one action to completion on this thread; `start` calls ThreadWorker::init() with the action's arguments */
+template<typename Start>
+static bool run(const ThreadAction::Action act, const QString &modName, const QString &pathMods, const QString &pathGame,
+                qint64 &ms, Start start)
+{
+    ThreadAction action(act, modName);
+    bool paused = false;
+    ThreadWorker worker(action, paused, pathMods, pathGame, nullptr);
+
+    QElapsedTimer timer;
+    timer.start();
+    start(worker);
+    ms = timer.elapsed();
+
+    return !action.errors();
+}
+
+/* Scans one mod through ScanEngine and waits for it; `files` gets the count of its last update */
+static bool scan(ScanEngine &engine, const QString &modName, const QString &path, const ThreadAction::ScanMode mode,
+                 qint64 &ms, qint64 &files)
+{
+    QEventLoop loop;
+    bool done = false;
+    files = 0;
+    QObject::connect(&engine, &ScanEngine::scanModUpdate, &loop,
+                     [&](const QString &name, qint64, const int fileCount){ if(name == modName) files = fileCount; });
+    QObject::connect(&engine, &ScanEngine::scanModReady, &loop,
+                     [&](const QString &name){ if(name == modName) { done = true; loop.quit(); } });
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.scan(modName, path, mode);
+    loop.exec(); // the engine's workers signal back through this thread's event loop
+    ms = timer.elapsed();
+
+    return done;
+}
+
+static void print(const QString &layout, const char *action, const int run, const bool ok, const Tree &tree, const qint64 ms)
+{
+    const double secs = ms > 0 ? double(ms)/1000 : 0;
+    std::printf("{\"bench\":\"actions\",\"layout\":\"%s\",\"action\":\"%s\",\"run\":%d,\"ok\":%s,"
+                "\"files\":%lld,\"bytes\":%lld,\"ms\":%lld,\"files_per_s\":%.0f,\"mb_per_s\":%.2f,\"peak_rss_kb\":%lld}\n",
+                qPrintable(layout), action, run, ok ? "true" : "false", tree.files, tree.bytes, ms,
+                secs > 0 ? tree.files/secs : 0.0, secs > 0 ? double(tree.bytes)/1024/1024/secs : 0.0, peakRssKB());
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv); // thread.cpp also holds the ProgressDiag widgets
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "layouts",     "Comma separated: small, huge, deep, links.", "LIST", "small,huge,deep,links" },
+        { "small-files", "Files in the small layout.",                  "N",    "100000" },
+        { "huge-mb",     "Size of each of the 4 huge files in MB.",     "N",    "512" },
+        { "runs",        "Runs per layout.",                            "N",    "1" },
+        { "root",        "Work folder (default: a temporary folder).", "PATH" },
+        { "keep",        "Don't delete the work folder." }
+    });
+    parser.process(a);
+
+    QTemporaryDir tmp(parser.isSet("root") ? parser.value("root")+"/wmmbench-XXXXXX" : QString());
+    tmp.setAutoRemove(!parser.isSet("keep"));
+    if(!tmp.isValid())
+    {
+        std::fprintf(stderr, "can't create work folder\n");
+        return 1;
+    }
+
+    const QString &root     = tmp.path(),
+                  &pathMods = root+"/mods",
+                  &pathGame = root+"/game";
+    QDir().mkpath(pathMods);
+    QDir().mkpath(pathGame);
+    BackupManifest::setPath(root+"/backups.idx"); // keep the real ones next to the exe out of it
+    Overlay::setPath(root+"/overlay.idx");
+    ModStore::setPath(pathMods);
+    ModManifest::setPath(root+"/manifests");
+
+    const int runs = std::max(parser.value("runs").toInt(), 1);
+    for(const QString &layout : parser.value("layouts").split(',', QString::SkipEmptyParts))
+        for(int i=0; i < runs; ++i)
+        {
+            const QString &src = root+"/src_"+layout, &modName = "mod_"+layout;
+            const Tree &tree = generate(layout, src, parser);
+            if(!tree.ok)
+            {
+                std::fprintf(stderr, "layout %s: couldn't generate the tree, skipped\n", qPrintable(layout));
+                print(layout, "generate", i, false, tree, 0);
+                continue;
+            }
+
+            qint64 ms, files;
+            bool ok;
+            ScanEngine engine(QString("%0/index_%1_%2.idx").arg(root, layout).arg(i)); // cold: nothing indexed yet
+
+            ok = run(ThreadAction::Add, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(true, src, pathMods+"/"+modName); });
+            print(layout, "add_copy", i, ok, tree, ms);
+
+            ok = scan(engine, modName, pathMods+"/"+modName, ThreadAction::IndexedScan, ms, files) && files == tree.files;
+            print(layout, "scan_indexed_cold", i, ok, tree, ms);
+
+            ok = scan(engine, modName, pathMods+"/"+modName, ThreadAction::IndexedScan, ms, files) && files == tree.files;
+            print(layout, "scan_indexed_warm", i, ok, tree, ms);
+
+            ok = scan(engine, modName, pathMods+"/"+modName, ThreadAction::FullScan, ms, files) && files == tree.files;
+            print(layout, "scan_full", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Dedup, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(0, modName); });
+            print(layout, "dedup", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Verify, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(0, modName); });
+            print(layout, "verify", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Verify, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(0, modName); });
+            print(layout, "verify_again", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Pack, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(0, modName); });
+            print(layout, "pack", i, ok, tree, ms);
+
+            ok = scan(engine, modName+".mpq", pathMods+"/"+modName+".mpq", ThreadAction::FullScan, ms, files)
+                 && files == tree.files;
+            print(layout, "scan_packed", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Mount, modName+".mpq", pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(); });
+            print(layout, "mount_packed", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Unmount, modName+".mpq", pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(); });
+            print(layout, "unmount_packed", i, ok, tree, ms);
+            QFile::remove(pathMods+"/"+modName+".mpq");
+
+            ok = run(ThreadAction::Mount, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(); });
+            print(layout, "mount", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Unmount, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(); });
+            print(layout, "unmount", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Mount, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(true); });
+            print(layout, "mount_overlay", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Unmount, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(); });
+            print(layout, "unmount_overlay", i, ok, tree, ms);
+
+            const QString &patchName = "patch_"+layout, &stackName = LayerStack::name({ modName, patchName });
+            QDir().mkpath(pathMods+"/"+patchName);
+            QFile patch(pathMods+"/"+patchName+"/patch.txt");
+            if(!patch.open(QIODevice::WriteOnly))
+            {
+                std::fprintf(stderr, "layout %s: couldn't create the patch mod, layered mount skipped\n", qPrintable(layout));
+                print(layout, "mount_layered", i, false, tree, 0);
+            }
+            else
+            {
+                patch.close();
+                for(const char *label : { "mount_layered", "mount_layered_again" })
+                {
+                    ok = run(ThreadAction::Mount, stackName, pathMods, pathGame, ms,
+                             [&](ThreadWorker &w){ w.init(0, modName+"/"+patchName); });
+                    print(layout, label, i, ok, tree, ms);
+
+                    run(ThreadAction::Unmount, stackName, pathMods, pathGame, ms, [&](ThreadWorker &w){ w.init(); });
+                }
+            }
+            QDir(LayerStack::root(pathMods, stackName)).removeRecursively();
+            QFile::remove(LayerStack::root(pathMods, stackName)+".wmml");
+            QDir(pathMods+"/"+patchName).removeRecursively();
+
+            ok = run(ThreadAction::Delete, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(tree.bytes, QString::number(tree.files)); });
+            print(layout, "delete", i, ok, tree, ms);
+
+            ok = run(ThreadAction::Add, modName, pathMods, pathGame, ms,
+                     [&](ThreadWorker &w){ w.init(false, src, pathMods+"/"+modName); });
+            print(layout, "add_move", i, ok, tree, ms);
+
+            run(ThreadAction::Delete, modName, pathMods, pathGame, ms,
+                [&](ThreadWorker &w){ w.init(tree.bytes, QString::number(tree.files)); });
+            QDir(src).removeRecursively();
+            QDir(src+"_targets").removeRecursively();
+        }
+
+    return 0;
+}
@@ -0,0 +1,13 @@
+#-------------------------------------------------
+#
+# Benchmarks: console apps, not part of the release build.
+# Run from a Qt command prompt: qmake bench.pro && make
+#
+#-------------------------------------------------
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    dirlist \
+    actions \
+    conflicts \
+    mpq
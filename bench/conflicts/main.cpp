@@ -0,0 +1,101 @@
+/* Times the conflict index on synthetic mods (in memory, no files):
+ *   build:     every mod's paths indexed, as the scans of a full refresh do
+ *   providers: "which mods provide path X", for random paths of the pool
+ *   conflicts: "what does mod A share with the others and the game folder", for every mod
+ *   rescan:    one mod's paths replaced, as when a single mod is rescanned
+ * Each mod takes --paths paths out of a pool shared by all mods (so they overlap), in random letter case.
+ * Prints one JSON object per line.
+ *
+ * bench_conflicts [--mods N] [--paths N] [--pool N] [--queries N] [--runs N] */
+#include "conflictindex.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static QStringList pool(const int size)
+{
+    static const char *const dirs[] = { "Units", "Abilities", "Doodads", "Textures", "UI\\Widgets", "Sound\\Music\\mp3Music" };
+    QStringList paths;
+    for(int i=0; i < size; ++i)
+        paths << QString("%0\\Sub%1\\File%2.blp").arg(dirs[i % 6]).arg(i / 600).arg(i);
+    return paths;
+}
+
+static QString mixCase(QString path, std::mt19937 &rng)
+{
+    for(QChar &ch : path)
+        if(ch.isLetter() && rng() % 2) ch = ch.isUpper() ? ch.toLower() : ch.toUpper();
+    return path;
+}
+
+static void print(const char *op, const int run, const qint64 count, const qint64 ns)
+{
+    std::printf("{\"bench\":\"conflicts\",\"op\":\"%s\",\"run\":%d,\"count\":%lld,\"ms\":%.3f,\"us_per_op\":%.3f}\n",
+                op, run, count, double(ns)/1e6, count ? double(ns)/1e3/count : 0.0);
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "mods",    "Mods (plus the game folder).",    "N", "300" },
+        { "paths",   "Paths per mod.",                  "N", "2000" },
+        { "pool",    "Distinct paths all mods draw from.", "N", "60000" },
+        { "queries", "providers() lookups per run.",    "N", "100000" },
+        { "runs",    "Timed runs.",                     "N", "3" }
+    });
+    parser.process(a);
+
+    const int modCount = std::max(parser.value("mods").toInt(), 1),
+              perMod   = std::max(parser.value("paths").toInt(), 1),
+              queries  = std::max(parser.value("queries").toInt(), 1);
+    const QStringList &paths = pool(std::max(parser.value("pool").toInt(), perMod));
+
+    std::mt19937 rng(42);
+    std::vector<QStringList> mods(size_t(modCount)+1); // [modCount]: the game folder
+    for(QStringList &mod : mods)
+        for(int i=0; i < perMod; ++i) mod << mixCase(paths[int(rng() % unsigned(paths.size()))], rng);
+
+    QStringList lookups;
+    for(int i=0; i < queries; ++i) lookups << mixCase(paths[int(rng() % unsigned(paths.size()))], rng);
+
+    const int runs = std::max(parser.value("runs").toInt(), 1);
+    for(int run=0; run < runs; ++run)
+    {
+        ConflictIndex index;
+        QElapsedTimer timer;
+
+        timer.start();
+        for(int i=0; i < modCount; ++i) index.setMod(QString("mod%0").arg(i), mods[size_t(i)]);
+        index.setMod(ConflictIndex::GAME, mods.back());
+        print("build", run, qint64(modCount+1)*perMod, timer.nsecsElapsed());
+
+        qint64 found = 0;
+        timer.restart();
+        for(const QString &path : lookups) found += index.providers(path).size();
+        print("providers", run, queries, timer.nsecsElapsed());
+
+        qint64 conflicts = 0;
+        timer.restart();
+        for(int i=0; i < modCount; ++i) conflicts += qint64(index.conflicts(QString("mod%0").arg(i)).size());
+        print("conflicts", run, modCount, timer.nsecsElapsed());
+
+        timer.restart();
+        index.setMod("mod0", mods[1]);
+        print("rescan", run, perMod, timer.nsecsElapsed());
+
+        std::fprintf(stderr, "run %d: %lld providers found, %lld conflicting paths\n", run, found, conflicts);
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = bench_dirlist
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../dirlister.cpp
+
+HEADERS += \
+    ../../dirlister.h
@@ -0,0 +1,138 @@
+/* Compares the two ways of sizing a folder tree:
+ *   qfileinfo: QDirIterator(Subdirectories) + one QFileInfo per file (the scanners before DirLister)
+ *   dirlister: DirLister, size and type from FindFirstFileExW/FindNextFileW
+ * on a synthetic tree (default 1M files, 100 per folder, 3 levels). Prints one JSON object per line.
+ *
+ * bench_dirlist [--files N] [--per-dir N] [--runs N] [--root PATH] [--keep] */
+#include "dirlister.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <cstdio>
+
+struct Result { qint64 files = 0, bytes = 0, ms = 0; };
+
+static void generate(const QString &root, const int files, const int perDir)
+{
+    int made = 0;
+    for(int a=0; made < files; ++a)
+        for(int b=0; b < perDir && made < files; ++b)
+        {
+            const QString &dir = QString("%0/d%1/d%2").arg(root).arg(a).arg(b);
+            QDir().mkpath(dir);
+
+            for(int i=0; i < perDir && made < files; ++i, ++made)
+            {
+                QFile file(QString("%0/f%1.txt").arg(dir).arg(i));
+                if(file.open(QIODevice::WriteOnly)) file.write(QByteArray(made % 64, 'x')); // 0-63 bytes
+            }
+        }
+}
+
+static Result viaQFileInfo(const QString &root)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    for(QDirIterator it(root, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories);
+        it.hasNext(); )
+    {
+        it.next();
+        result.bytes += it.fileInfo().size();
+        ++result.files;
+    }
+
+    result.ms = timer.elapsed();
+    return result;
+}
+
+static Result viaDirLister(const QString &root)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList dirs(root);
+    DirLister::Entry entry;
+    while(!dirs.isEmpty())
+    {
+        const QString dir = dirs.takeLast();
+        for(DirLister lister(dir); lister.next(entry); )
+        {
+            if(entry.link)
+            {
+                const QFileInfo &fi(dir+"/"+entry.name);
+                if(!fi.isDir())
+                {
+                    result.bytes += fi.size();
+                    ++result.files;
+                }
+            }
+            else if(entry.dir) dirs << dir+"/"+entry.name;
+            else
+            {
+                result.bytes += entry.size;
+                ++result.files;
+            }
+        }
+    }
+
+    result.ms = timer.elapsed();
+    return result;
+}
+
+static void print(const char *method, const int run, const Result &result)
+{
+    std::printf("{\"bench\":\"dirlist\",\"method\":\"%s\",\"run\":%d,\"files\":%lld,\"bytes\":%lld,\"ms\":%lld,\"files_per_s\":%.0f}\n",
+                method, run, result.files, result.bytes, result.ms,
+                result.ms > 0 ? double(result.files)*1000/result.ms : 0.0);
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "files",   "Files to generate.",                 "N",    "1000000" },
+        { "per-dir", "Files (and folders) per folder.",    "N",    "100" },
+        { "runs",    "Timed runs per method.",             "N",    "3" },
+        { "root",    "Use this tree instead of generating one.", "PATH" },
+        { "keep",    "Don't delete the generated tree." }
+    });
+    parser.process(a);
+
+    QTemporaryDir tmp;
+    QString root = parser.value("root");
+    if(root.isEmpty())
+    {
+        tmp.setAutoRemove(!parser.isSet("keep"));
+        root = tmp.path();
+
+        QElapsedTimer timer;
+        timer.start();
+        generate(root, parser.value("files").toInt(), std::max(parser.value("per-dir").toInt(), 1));
+        std::fprintf(stderr, "generated %s in %lld ms\n", qPrintable(root), timer.elapsed());
+    }
+
+    viaDirLister(root); // warm the file system cache for both
+
+    const int runs = std::max(parser.value("runs").toInt(), 1);
+    for(int run=0; run < runs; ++run)
+    {
+        print("qfileinfo", run, viaQFileInfo(root));
+        print("dirlister", run, viaDirLister(root));
+    }
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/* Times MpqArchive on the archives of tests/mpq/mpqfixture.h, and prints one JSON object per line:
+ *   {"bench":"mpq","archive":...,"op":...,"run":...,"ok":...,"files":...,"bytes":...,"ms":...}
+ *
+ * Archives: packed (--files files packed with MpqWriter), fixture (made byte by byte).
+ * Ops: pack (MpqWriter), open+size (fileCount and unpackedSize from the tables), entries (names from (listfile)).
+ * "ok" compares each op's result with what went into the archive; test_mpq is what fails on a mismatch.
+ *
+ * bench_mpq [--files N] [--runs N] [--root PATH] [--keep] */
+#include "mpqfixture.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <cstdio>
+
+static void print(const char *archive, const char *op, const int run, const bool ok, const Listing &listing, const qint64 ns)
+{
+    qint64 bytes = 0;
+    for(const std::pair<const QString, qint64> &file : listing) bytes += file.second;
+
+    std::printf("{\"bench\":\"mpq\",\"archive\":\"%s\",\"op\":\"%s\",\"run\":%d,\"ok\":%s,\"files\":%zu,\"bytes\":%lld,"
+                "\"ms\":%.3f}\n", archive, op, run, ok ? "true" : "false", listing.size(), bytes, double(ns)/1e6);
+    std::fflush(stdout);
+}
+
+static void timeReads(const char *archive, const QString &path, const Listing &listing, const int run)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    bool ok;
+    {
+        const MpqArchive mpq(path);
+        ok = checkSize(mpq, listing);
+    }
+    print(archive, "open+size", run, ok, listing, timer.nsecsElapsed());
+
+    const MpqArchive mpq(path);
+    timer.restart();
+    const std::vector<MpqArchive::Entry> &entries = mpq.entries();
+    const qint64 ns = timer.nsecsElapsed();
+    print(archive, "entries", run, checkEntries(entries, listing), listing, ns);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "files", "Files in the packed archive.", "N", "2000" },
+        { "runs",  "Timed runs.",                  "N", "3" },
+        { "root",  "Work folder (default: system temp).", "PATH" },
+        { "keep",  "Don't delete the work folder." }
+    });
+    parser.process(a);
+
+    QTemporaryDir tmp(parser.isSet("root") ? parser.value("root")+"/wmmbench-XXXXXX" : QString());
+    tmp.setAutoRemove(!parser.isSet("keep"));
+    if(!tmp.isValid())
+    {
+        std::fprintf(stderr, "can't create work folder\n");
+        return 1;
+    }
+
+    Listing packedListing, fixtureListing;
+    const std::vector<MpqWriter::File> &files = generate(tmp.path()+"/src", std::max(parser.value("files").toInt(), 1),
+                                                         packedListing);
+    if(files.empty() || !fixture(tmp.path()+"/fixture.mpq", fixtureListing))
+    {
+        std::fprintf(stderr, "couldn't write the source files\n");
+        return 1;
+    }
+
+    const int runs = std::max(parser.value("runs").toInt(), 1);
+    for(int run=0; run < runs; ++run)
+    {
+        const QString &packed = tmp.path()+"/packed.mpq";
+        QFile::remove(packed);
+
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = MpqWriter::pack(packed, files) == MpqWriter::Packed;
+        print("packed", "pack", run, ok, packedListing, timer.nsecsElapsed());
+
+        timeReads("packed",  packed,                    packedListing,  run);
+        timeReads("fixture", tmp.path()+"/fixture.mpq", fixtureListing, run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = bench_mpq
+TEMPLATE = app
+
+INCLUDEPATH += ../.. ../../tests/mpq
+
+SOURCES += \
+    main.cpp \
+    ../../tests/mpq/mpqfixture.cpp \
+    ../../mpqarchive.cpp \
+    ../../mpqwriter.cpp
+
+HEADERS += \
+    ../../tests/mpq/mpqfixture.h \
+    ../../mpqarchive.h \
+    ../../mpqwriter.h
@@ -1,26 +1,53 @@
 #include "config.h"
+#include <QSaveFile>
+#include <QFile>
 #include <QDir>
-#include <fstream>
+#include <algorithm>
 #include <winerror.h>
 
-const QChar   Config::CFG_SEP       = '=';
-const QString Config::vOn           = "1",
-              Config::vOff          = "0",
-              Config::kGamePath     = "GamePath",
-              Config::kHideEmpty    = "HideEmptyMods";/*,
-              Config::kMounted      = "Mounted",
-              Config::kMountedError = "MountedError";*/
+const QChar   Config::CFG_SEP = '=';
+const QString Config::vOn     = "1",
+              Config::vOff    = "0";
+
+const std::array<const QString, Config::Key_Size> Config::NAMES = {
+    "GamePath",
+    "HideEmptyMods",
+    "ProgressIntervalMs", // at most one progress update per mod every X ms...
+    "ProgressFileBudget", // ...or every X files (0: time budget only)
+    "BackupMaxDays",      // Clean Up Backups: delete backups older than X days...
+    "BackupMaxMB",        // ...and the oldest ones above X MB in total (0: no limit)
+    "DedupOnAdd",         // link files of added mods that other mods already have
+    "Layers"              // last layered mount: mod names '/'-separated, bottom first
+    /*"Mounted",
+    "MountedError"*/
+};
+
+class ConfigWriter : public QRunnable
+{
+               Config &cfg;
+public:        explicit ConfigWriter(Config &cfg) : cfg(cfg) {}
+               void run() override { cfg.write(); }
+};
 
 Config::Config()
 {
+    writer.setMaxThreadCount(1);
+
  // LOAD CONFIG FILE
-    std::ifstream cfgReader(pathCfg);
-    for(std::string line; std::getline(cfgReader, line); )
-    {
-        const QStringList &list = QString::fromStdString(line).split(CFG_SEP);
-        if(list.size() >= 2) saveSetting(list[0], list[1]);
-    }
-    cfgReader.close();
+    Snapshot *loaded = new Snapshot;
+    QFile cfgReader(pathCfg);
+    if(cfgReader.open(QIODevice::ReadOnly))
+        while(!cfgReader.atEnd())
+        {
+            const QStringList &list = QString::fromUtf8(cfgReader.readLine()).trimmed().split(CFG_SEP);
+            if(list.size() < 2 || list[0].isEmpty() || list[1].isEmpty()) continue;
+
+            const auto it = std::find(NAMES.begin(), NAMES.end(), list[0]);
+            if(it == NAMES.end()) loaded->unknown.push_back({ list[0], list[1] });
+            else loaded->values[size_t(it-NAMES.begin())] = list[0] == NAMES[kGamePath] ? QDir::fromNativeSeparators(list[1])
+                                                                                        : list[1];
+        }
+    publish(loaded);
 
  // LOAD DEFAULTS
     bool configChanged = false;
@@ -55,32 +82,81 @@ Config::Config()
         saveSetting(kHideEmpty, vOn);
         configChanged = true;
     }
+    if(getSetting(kProgressMs).isEmpty())
+    {
+        saveSetting(kProgressMs, "50");
+        configChanged = true;
+    }
+    if(getSetting(kProgressFiles).isEmpty())
+    {
+        saveSetting(kProgressFiles, vOff);
+        configChanged = true;
+    }
+    if(getSetting(kBackupMaxDays).isEmpty())
+    {
+        saveSetting(kBackupMaxDays, "30");
+        configChanged = true;
+    }
+    if(getSetting(kBackupMaxMB).isEmpty())
+    {
+        saveSetting(kBackupMaxMB, vOff);
+        configChanged = true;
+    }
+    if(getSetting(kDedupOnAdd).isEmpty())
+    {
+        saveSetting(kDedupOnAdd, vOff);
+        configChanged = true;
+    }
 
     if(configChanged) saveConfig();
 }
 
-void Config::saveSetting(const QString &key, QString value)
+Config::~Config()
+{
+    writer.waitForDone(); // the last queued write
+}
+
+void Config::publish(Snapshot *snapshot)
+{
+    for(size_t key=0; key < Key_Size; ++key)
+        if(TYPES[key] != Text) snapshot->numbers[key] = snapshot->values[key].toLongLong();
+
+    snapshots.emplace_back(snapshot);
+    current.storeRelease(snapshot);
+}
+
+void Config::saveSetting(const Key key, QString value)
 {
-    if(!key.isEmpty())
+    if(key == kGamePath) value = QDir::fromNativeSeparators(value);
+
+    QMutexLocker lock(&mutex);
+    if(getSetting(key) != value)
     {
-        if(value.isEmpty()) deleteSetting(key);
-        else
-        {
-            if(key == kGamePath) value = QDir::fromNativeSeparators(value);
-            if(settings.find(key) == settings.end()) settings.insert({ key, value });
-            else settings[key] = value;
-        }
+        Snapshot *snapshot = new Snapshot(*current.loadAcquire());
+        snapshot->values[key] = value;
+        publish(snapshot);
     }
 }
 
-void Config::saveConfig() const
+void Config::saveConfig()
+{
+    if(pending.testAndSetOrdered(0, 1)) writer.start(new ConfigWriter(*this));
+}
+
+void Config::write()
 {
-    std::ofstream cfgWriter(pathCfg);
+    pending.storeRelease(0); // a save from here on queues another write
+    const Snapshot &snapshot = *current.loadAcquire();
 
-    for(const std::pair<const QString, const QString> &setting : settings)
-        cfgWriter << QString("%0%1%2").arg(setting.first, CFG_SEP, setting.second).toStdString() << std::endl;
+    QByteArray cfg;
+    for(size_t key=0; key < Key_Size; ++key)
+        if(!snapshot.values[key].isEmpty())
+            cfg += QString("%0%1%2\n").arg(NAMES[key], CFG_SEP, snapshot.values[key]).toUtf8();
+    for(const std::pair<QString, QString> &setting : snapshot.unknown)
+        cfg += QString("%0%1%2\n").arg(setting.first, CFG_SEP, setting.second).toUtf8();
 
-    cfgWriter.close();
+    QSaveFile cfgWriter(pathCfg);
+    if(cfgWriter.open(QIODevice::WriteOnly) && cfgWriter.write(cfg) == cfg.size()) cfgWriter.commit();
 }
 
 bool Config::regOpenWC3(const REGSAM &accessMode, HKEY &hKey)
@@ -1,34 +1,86 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include "_uo_map_qs.h"
 #include <QCoreApplication>
+#include <QAtomicPointer>
+#include <QThreadPool>
+#include <QMutex>
+#include <array>
+#include <memory>
+#include <vector>
 
 #include <windef.h>  // winbase.h needs to be
 #include <winbase.h> // preceded by windef.h
 #include <apisetcconv.h>
 #include <winreg.h>
 
+/* Settings live in immutable snapshots: getSetting is one atomic load and an array index, from any thread,
+ * and returns a reference that stays valid as long as the Config (replaced snapshots are kept, there are only
+ * ever a handful). Every key has a type in TYPES; numbers and flags are parsed once, when a snapshot is published,
+ * and getNumber/getFlag only compile for keys of that type. saveSetting publishes a new snapshot; saveConfig only
+ * queues a write, so the GUI thread never waits on the disk. Queued writes coalesce into one, made by a single
+ * background thread through QSaveFile (a crash leaves the old config.cfg whole), and the destructor waits for the
+ * last one. */
 class Config
 {
-         static const QChar   CFG_SEP;
-public:  static const QString vOn, vOff, kGamePath, kHideEmpty; //, kMounted, kMountedError;
+public:  enum Key { kGamePath, kHideEmpty, kProgressMs, kProgressFiles, kBackupMaxDays, kBackupMaxMB, kDedupOnAdd,
+                    kLayers, Key_Size }; //, kMounted, kMountedError
+         enum Type { Text, Number, Flag };
 
-         const QString     pathMods = QCoreApplication::applicationDirPath()+"/mods";
-private: const std::string pathCfg  = QCoreApplication::applicationDirPath().toStdString()+"/config.cfg";
+         static constexpr std::array<Type, Key_Size> TYPES // by Key
+         {{ /* kGamePath      */ Text,
+            /* kHideEmpty     */ Flag,
+            /* kProgressMs    */ Number,
+            /* kProgressFiles */ Number,
+            /* kBackupMaxDays */ Number,
+            /* kBackupMaxMB   */ Number,
+            /* kDedupOnAdd    */ Flag,
+            /* kLayers        */ Text }};
 
-         std::unordered_map<QString, QString> settings;
+         static const QString vOn, vOff;
 
-public:  Config();
+         const QString     pathMods      = QCoreApplication::applicationDirPath()+"/mods",
+                           pathIndex     = QCoreApplication::applicationDirPath()+"/mods.idx",
+                           pathBackups   = QCoreApplication::applicationDirPath()+"/backups.idx",
+                           pathOverlay   = QCoreApplication::applicationDirPath()+"/overlay.idx",
+                           pathManifests = QCoreApplication::applicationDirPath()+"/manifests";
+
+private: static const QChar   CFG_SEP;
+         static const std::array<const QString, Key_Size> NAMES; // as written in config.cfg
+
+         struct Snapshot {
+             std::array<QString, Key_Size> values;                  // empty: not set
+             std::array<qint64,  Key_Size> numbers{};               // Number and Flag values parsed, 0 if not one (vOn: 1)
+             std::vector<std::pair<QString, QString> > unknown;     // kept as they were read
+         };
+
+         const QString pathCfg = QCoreApplication::applicationDirPath()+"/config.cfg";
 
-         QString getSetting   (const QString &key)
-         { return settings.find(key) == settings.end() ? QString() : settings[key]; }
+         QAtomicPointer<const Snapshot> current;
+         std::vector<std::unique_ptr<const Snapshot> > snapshots; // every one published, the last is current
+         QMutex      mutex;   // between writers of snapshots
+         QThreadPool writer;  // one thread
+         QAtomicInt  pending; // a write is queued and hasn't taken its snapshot yet
+
+         void publish(Snapshot *snapshot);
+         void write();
+
+         friend class ConfigWriter;
+
+public:  Config();
+         ~Config();
 
-         void    deleteSetting(const QString &key)
-         { if(settings.find(key) != settings.end()) settings.erase(key); }
+         const QString &getSetting(const Key key) const { return current.loadAcquire()->values[key]; }
+         template<Key key> qint64 getNumber() const
+         {   static_assert(TYPES[key] == Number, "Config::getNumber: not a Number key");
+             return current.loadAcquire()->numbers[key]; }
+         template<Key key> bool   getFlag() const
+         {   static_assert(TYPES[key] == Flag, "Config::getFlag: not a Flag key");
+             return current.loadAcquire()->numbers[key] != 0; }
 
-         void    saveSetting  (const QString &key, QString value);
-         void    saveConfig()  const;
+         void    deleteSetting(const Key key) { saveSetting(key, QString()); }
+         void    saveSetting  (const Key key, QString value);
+         void    saveConfig();
 
          static bool regOpenWC3(const REGSAM &accessMode, HKEY &hKey);
 };
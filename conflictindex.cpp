@@ -0,0 +1,180 @@
+#include "conflictindex.h"
+
+#include <QSet>
+#include <algorithm>
+
+const QString ConflictIndex::GAME = QStringLiteral(u"<game>");
+
+QString ConflictIndex::fold(const QString &component)
+{
+    QString folded(component);
+    for(QChar &ch : folded)
+        if(ch >= 'a' && ch <= 'z') ch = QChar(ch.unicode()-('a'-'A')); // the game folds ASCII only
+    return folded;
+}
+
+QStringList ConflictIndex::split(const QString &path)
+{ return QString(path).replace('/', '\\').split('\\', QString::SkipEmptyParts); }
+
+quint32 ConflictIndex::intern(const QString &component)
+{
+    const auto it = interned.insert({ fold(component), quint32(names.size()) });
+    if(it.second) names.push_back(component);
+    return it.first->second;
+}
+
+quint32 ConflictIndex::modId(const QString &modName)
+{
+    const auto it = modIds.insert({ modName, quint32(modNames.size()) });
+    if(it.second)
+    {
+        modNames.push_back(modName);
+        leaves.emplace_back();
+    }
+    return it.first->second;
+}
+
+int ConflictIndex::find(const QString &path) const
+{
+    quint32 node = 0;
+    for(const QString &component : split(path))
+    {
+        const auto itName = interned.find(fold(component));
+        if(itName == interned.end()) return -1;
+
+        const auto itChild = nodes[node].children.find(itName->second);
+        if(itChild == nodes[node].children.end()) return -1;
+        node = itChild->second;
+    }
+    return node ? int(node) : -1;
+}
+
+QString ConflictIndex::pathOf(quint32 node) const
+{
+    QStringList components;
+    for(; node; node = nodes[node].parent) components.prepend(names[nodes[node].name]);
+    return components.join('\\');
+}
+
+void ConflictIndex::clear(const quint32 mod)
+{
+    for(const quint32 node : leaves[mod])
+    {
+        std::vector<quint32> &mods = nodes[node].mods;
+        const auto it = std::lower_bound(mods.begin(), mods.end(), mod);
+        if(it != mods.end() && *it == mod) mods.erase(it);
+    }
+    leaves[mod].clear();
+}
+
+void ConflictIndex::setMod(const QString &modName, const QStringList &paths)
+{
+    QMutexLocker lock(&mutex);
+
+    const quint32 mod = modId(modName);
+    clear(mod);
+
+    std::vector<quint32> &modLeaves = leaves[mod];
+    modLeaves.reserve(size_t(paths.size()));
+    for(const QString &path : paths)
+    {
+        quint32 node = 0;
+        for(const QString &component : split(path))
+        {
+            const quint32 name = intern(component);
+            const auto it = nodes[node].children.find(name);
+            if(it != nodes[node].children.end()) node = it->second;
+            else
+            {
+                const quint32 child = quint32(nodes.size());
+                nodes[node].children.insert({ name, child });
+                nodes.emplace_back();
+                nodes.back().parent = node;
+                nodes.back().name   = name;
+                node = child;
+            }
+        }
+        if(!node) continue;
+
+        std::vector<quint32> &mods = nodes[node].mods;
+        const auto it = std::lower_bound(mods.begin(), mods.end(), mod);
+        if(it == mods.end() || *it != mod)
+        {
+            mods.insert(it, mod);
+            modLeaves.push_back(node);
+        }
+    }
+}
+
+void ConflictIndex::removeMod(const QString &modName)
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = modIds.find(modName);
+    if(it != modIds.end()) clear(it->second); // the id stays, unused, until the name comes back
+}
+
+void ConflictIndex::renameMod(const QString &modName, const QString &newName)
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = modIds.find(modName);
+    if(it == modIds.end() || modName == newName) return;
+
+    const auto itTaken = modIds.find(newName); // a mod of that name went away earlier: its id is dropped
+    if(itTaken != modIds.end())
+    {
+        clear(itTaken->second);
+        modNames[itTaken->second].clear();
+        modIds.erase(itTaken);
+    }
+
+    const quint32 mod = it->second; // erasing another key leaves `it` valid
+    modIds.erase(it);
+    modIds.insert({ newName, mod });
+    modNames[mod] = newName;
+}
+
+void ConflictIndex::retain(const QStringList &keep)
+{
+    const QSet<QString> kept = QSet<QString>::fromList(keep);
+
+    QMutexLocker lock(&mutex);
+    for(const std::pair<const QString, quint32> &mod : modIds)
+        if(mod.first != GAME && !kept.contains(mod.first)) clear(mod.second);
+}
+
+QStringList ConflictIndex::providers(const QString &path) const
+{
+    QMutexLocker lock(&mutex);
+
+    QStringList providers;
+    const int node = find(path);
+    if(node >= 0)
+        for(const quint32 mod : nodes[size_t(node)].mods) providers << modNames[mod];
+    return providers;
+}
+
+std::vector<ConflictIndex::Conflict> ConflictIndex::conflicts(const QString &modName) const
+{
+    QMutexLocker lock(&mutex);
+
+    std::vector<Conflict> conflicts;
+    const auto it = modIds.find(modName);
+    if(it == modIds.end()) return conflicts;
+
+    for(const quint32 node : leaves[it->second])
+    {
+        const std::vector<quint32> &mods = nodes[node].mods;
+        if(mods.size() < 2) continue;
+
+        Conflict conflict;
+        conflict.path = pathOf(node);
+        for(const quint32 mod : mods)
+            if(mod != it->second) conflict.modNames << modNames[mod];
+        conflicts.push_back(std::move(conflict));
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), [](const Conflict &a, const Conflict &b) { return a.path < b.path; });
+    return conflicts;
+}
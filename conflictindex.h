@@ -0,0 +1,58 @@
+#ifndef CONFLICTINDEX_H
+#define CONFLICTINDEX_H
+
+#include "_uo_map_qs.h"
+#include <QStringList>
+#include <QMutex>
+#include <vector>
+
+/* Which mods, and which loose files of the game folder, provide each relative path: what shadows what once
+ * Allow Local Files is on. Filled by the scan engine each time a mod scan completes, so a rescan only replaces
+ * that mod's paths. Path components are folded the way the game resolves names (ASCII case, '/' = '\')
+ * and interned once; the paths form a trie with a hash map of children per node, so a lookup costs
+ * one probe per component. Nodes are never freed: they are bounded by the distinct paths ever seen. */
+class ConflictIndex
+{
+public:  static const QString GAME; // the game folder, indexed like a mod
+
+         struct Conflict {
+             QString     path;
+             QStringList modNames; // the other providers
+         };
+
+private: struct Node {
+             quint32 parent = 0,
+                     name   = 0;                         // interned component, spelled as first seen
+             std::unordered_map<quint32, quint32> children; // interned component -> node
+             std::vector<quint32> mods;                     // providers, sorted
+         };
+
+         mutable QMutex mutex;
+         std::unordered_map<QString, quint32> interned; // folded component -> id
+         std::vector<QString> names;                    // id -> component
+         std::vector<Node>    nodes;                    // [0]: root
+         std::unordered_map<QString, quint32> modIds;
+         std::vector<QString> modNames;                 // id -> mod name
+         std::vector<std::vector<quint32> > leaves;     // mod id -> nodes it provides
+
+         static QStringList split(const QString &path);
+         quint32 intern(const QString &component);
+         quint32 modId (const QString &modName);
+         int     find  (const QString &path) const; // -1: not indexed
+         QString pathOf(quint32 node) const;
+         void    clear (const quint32 mod);
+
+public:  ConflictIndex() : nodes(1) {}
+
+         static QString fold(const QString &path); // as the game compares names: ASCII case only
+
+         void setMod   (const QString &modName, const QStringList &paths); // relative to the mod folder
+         void removeMod(const QString &modName);
+         void renameMod(const QString &modName, const QString &newName);
+         void retain   (const QStringList &keep); // the game folder is always kept
+
+         QStringList           providers(const QString &path) const;
+         std::vector<Conflict> conflicts(const QString &modName) const; // paths someone else provides too
+};
+
+#endif // CONFLICTINDEX_H
@@ -0,0 +1,225 @@
+#define WINVER _WIN32_WINNT_WIN7 //COPY_FILE_NO_BUFFERING and GetVolumeInformationByHandleW need Windows 7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "copyengine.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <vector>
+
+#include <windef.h>  // winbase.h needs to be
+#include <winbase.h> // preceded by windef.h
+#include <winioctl.h>
+
+#ifndef FSCTL_DUPLICATE_EXTENTS_TO_FILE // Windows Server 2016 / ReFS v2 SDK
+    #define FSCTL_DUPLICATE_EXTENTS_TO_FILE CTL_CODE(FILE_DEVICE_FILE_SYSTEM, 209, METHOD_BUFFERED, FILE_WRITE_ACCESS)
+    typedef struct _DUPLICATE_EXTENTS_DATA {
+        HANDLE        FileHandle;
+        LARGE_INTEGER SourceFileOffset;
+        LARGE_INTEGER TargetFileOffset;
+        LARGE_INTEGER ByteCount;
+    } DUPLICATE_EXTENTS_DATA;
+#endif
+#ifndef FILE_SUPPORTS_BLOCK_REFCOUNTING
+    #define FILE_SUPPORTS_BLOCK_REFCOUNTING 0x08000000
+#endif
+
+namespace {
+std::wstring native(const QString &path)
+{ return QDir::toNativeSeparators(path).toStdWString(); }
+
+struct Handle { // closes on scope exit
+    HANDLE h;
+    Handle(HANDLE h) : h(h) {}
+    ~Handle() { if(h != INVALID_HANDLE_VALUE) CloseHandle(h); }
+    operator HANDLE() const { return h; }
+    bool valid() const { return h != INVALID_HANDLE_VALUE; }
+};
+
+DWORD CALLBACK copyProgress(LARGE_INTEGER total, LARGE_INTEGER done, LARGE_INTEGER, LARGE_INTEGER,
+                            DWORD, DWORD, HANDLE, HANDLE, LPVOID data)
+{
+    const CopyEngine::Progress &progress = *static_cast<const CopyEngine::Progress*>(data);
+    return progress(done.QuadPart, total.QuadPart) ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+}
+}
+
+/********************************************************************/
+/*      COPY ENGINE     *********************************************/
+/********************************************************************/
+    CopyEngine::Result CopyEngine::copy(const QString &src, const QString &dst, const Progress &progress)
+    {
+        if(clone(src, dst)) return Cloned;
+
+        const qint64 size = QFileInfo(src).size();
+        BOOL cancel = FALSE;
+        if(CopyFileExW(native(src).c_str(), native(dst).c_str(), progress ? copyProgress : nullptr,
+                       progress ? const_cast<Progress*>(&progress) : nullptr, &cancel,
+                       COPY_FILE_FAIL_IF_EXISTS|(size > UNBUFFERED ? COPY_FILE_NO_BUFFERING : 0)))
+            return Copied;
+
+        switch(GetLastError())
+        {
+        case ERROR_REQUEST_ABORTED: return Cancelled; // dst already removed by CopyFileExW
+        case ERROR_FILE_EXISTS: case ERROR_FILE_NOT_FOUND: case ERROR_PATH_NOT_FOUND:
+        case ERROR_ACCESS_DENIED: case ERROR_DISK_FULL: case ERROR_SHARING_VIOLATION:
+            return Failed;
+        default:
+            return stream(src, dst, progress);
+        }
+    }
+
+    bool CopyEngine::clone(const QString &src, const QString &dst)
+    {
+        Handle hSrc(CreateFileW(native(src).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr));
+        if(!hSrc.valid()) return false;
+
+        DWORD fsFlags = 0, serialSrc = 0, serialDst = 0;
+        if(!GetVolumeInformationByHandleW(hSrc, nullptr, 0, &serialSrc, nullptr, &fsFlags, nullptr, 0)
+           || !(fsFlags & FILE_SUPPORTS_BLOCK_REFCOUNTING)) return false;
+
+        BY_HANDLE_FILE_INFORMATION info;
+        if(!GetFileInformationByHandle(hSrc, &info)) return false;
+
+        Handle hDst(CreateFileW(native(dst).c_str(), GENERIC_READ|GENERIC_WRITE|DELETE, 0, nullptr, CREATE_NEW,
+                                FILE_ATTRIBUTE_NORMAL, nullptr)); // read-only would keep a failed clone from being deleted
+        if(!hDst.valid()) return false;
+
+        bool cloned = GetVolumeInformationByHandleW(hDst, nullptr, 0, &serialDst, nullptr, nullptr, nullptr, 0)
+                      && serialSrc == serialDst; // clones only work within one volume
+
+        DWORD bytes;
+        if(cloned && info.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) // sparse-ness must match
+            cloned = DeviceIoControl(hDst, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes, nullptr);
+
+        wchar_t volume[MAX_PATH+1];
+        DWORD sectorsPerCluster = 0, bytesPerSector = 0, freeClusters, clusters;
+        if(cloned) cloned = GetVolumePathNameW(native(dst).c_str(), volume, MAX_PATH+1)
+                            && GetDiskFreeSpaceW(volume, &sectorsPerCluster, &bytesPerSector, &freeClusters, &clusters);
+
+        FILE_END_OF_FILE_INFO eof;
+        eof.EndOfFile.QuadPart = qint64(quint64(info.nFileSizeHigh) << 32 | info.nFileSizeLow);
+        if(cloned) cloned = SetFileInformationByHandle(hDst, FileEndOfFileInfo, &eof, sizeof(eof));
+
+        if(cloned && eof.EndOfFile.QuadPart > 0)
+        {
+            const qint64 cluster = qint64(sectorsPerCluster)*bytesPerSector; // clone ranges must be cluster aligned
+            DUPLICATE_EXTENTS_DATA extents;
+            extents.FileHandle = hSrc;
+            extents.SourceFileOffset.QuadPart = extents.TargetFileOffset.QuadPart = 0;
+            extents.ByteCount.QuadPart = (eof.EndOfFile.QuadPart+cluster-1)/cluster*cluster; // EOF may end mid-cluster
+
+            cloned = DeviceIoControl(hDst, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents),
+                                     nullptr, 0, &bytes, nullptr);
+        }
+
+        if(cloned)
+        {   // times and the attributes SetFileAttributes accepts; sparse-ness was set above
+            FILE_BASIC_INFO basic = {};
+            basic.CreationTime.LowPart    = info.ftCreationTime.dwLowDateTime;
+            basic.CreationTime.HighPart   = LONG(info.ftCreationTime.dwHighDateTime);
+            basic.LastAccessTime.LowPart  = info.ftLastAccessTime.dwLowDateTime;
+            basic.LastAccessTime.HighPart = LONG(info.ftLastAccessTime.dwHighDateTime);
+            basic.LastWriteTime.LowPart   = info.ftLastWriteTime.dwLowDateTime;
+            basic.LastWriteTime.HighPart  = LONG(info.ftLastWriteTime.dwHighDateTime);
+            basic.FileAttributes = info.dwFileAttributes & (FILE_ATTRIBUTE_READONLY|FILE_ATTRIBUTE_HIDDEN|FILE_ATTRIBUTE_SYSTEM
+                                                            |FILE_ATTRIBUTE_ARCHIVE|FILE_ATTRIBUTE_NOT_CONTENT_INDEXED);
+            SetFileInformationByHandle(hDst, FileBasicInfo, &basic, sizeof(basic));
+            return true;
+        }
+
+        FILE_DISPOSITION_INFO dispose = { TRUE }; // remove the half made file when the handle closes
+        SetFileInformationByHandle(hDst, FileDispositionInfo, &dispose, sizeof(dispose));
+        return false;
+    }
+
+    CopyEngine::Result CopyEngine::stream(const QString &src, const QString &dst, const Progress &progress)
+    {
+        Handle hSrc(CreateFileW(native(src).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN|FILE_FLAG_OVERLAPPED, nullptr));
+        if(!hSrc.valid()) return Failed;
+
+        Handle hDst(CreateFileW(native(dst).c_str(), GENERIC_WRITE|DELETE, 0, nullptr, CREATE_NEW,
+                                FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED, nullptr));
+        if(!hDst.valid()) return Failed;
+
+        LARGE_INTEGER total;
+        if(!GetFileSizeEx(hSrc, &total)) total.QuadPart = 0;
+
+        // Double buffering: read chunk n+1 while chunk n is being written
+        std::vector<char> buffers[2] = { std::vector<char>(size_t(CHUNK)), std::vector<char>(size_t(CHUNK)) };
+        OVERLAPPED rd = {}, wr = {};
+        Handle rdEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr)), wrEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+        rd.hEvent = rdEvent;
+        wr.hEvent = wrEvent;
+
+        bool reading = false, writing = false;
+        auto issueRead = [&](const int buf, const qint64 offset) {
+            rd.Offset = DWORD(offset); rd.OffsetHigh = DWORD(offset >> 32);
+            reading = ReadFile(hSrc, buffers[buf].data(), DWORD(CHUNK), nullptr, &rd) || GetLastError() == ERROR_IO_PENDING
+                      || GetLastError() == ERROR_HANDLE_EOF;
+            return reading;
+        };
+        auto finish = [](HANDLE h, OVERLAPPED &ov, DWORD &n) {
+            return GetOverlappedResult(h, &ov, &n, TRUE) || GetLastError() == ERROR_HANDLE_EOF;
+        };
+
+        Result result = Streamed;
+        qint64 offset = 0;
+        DWORD n = 0;
+
+        if(!issueRead(0, 0)) result = Failed;
+        for(int buf=0; result == Streamed; buf ^= 1)
+        {
+            n = 0;
+            reading = false;
+            if(!finish(hSrc, rd, n)) { result = Failed; break; }
+
+            DWORD written;
+            if(writing && !finish(hDst, wr, written)) { result = Failed; break; } // frees the other buffer
+            writing = false;
+
+            if(n == 0) break; // EOF
+
+            const qint64 chunkOffset = offset;
+            offset += n;
+            if(n == DWORD(CHUNK) && !issueRead(buf^1, offset)) { result = Failed; break; }
+
+            wr.Offset = DWORD(chunkOffset); wr.OffsetHigh = DWORD(chunkOffset >> 32);
+            if(!WriteFile(hDst, buffers[buf].data(), n, nullptr, &wr) && GetLastError() != ERROR_IO_PENDING)
+            { result = Failed; break; }
+            writing = true;
+
+            if(progress && !progress(offset, total.QuadPart)) result = Cancelled;
+            if(n < DWORD(CHUNK)) // short read: EOF
+            {
+                if(!finish(hDst, wr, written)) result = Failed;
+                writing = false;
+                break;
+            }
+        }
+
+        if(result != Streamed)
+        {   // the kernel may still be reading into or writing from `buffers`: wait for it before they go
+            DWORD done;
+            CancelIo(hSrc);
+            if(reading) GetOverlappedResult(hSrc, &rd, &done, TRUE);
+            CancelIo(hDst);
+            if(writing) GetOverlappedResult(hDst, &wr, &done, TRUE);
+
+            FILE_DISPOSITION_INFO dispose = { TRUE };
+            SetFileInformationByHandle(hDst, FileDispositionInfo, &dispose, sizeof(dispose));
+            return result;
+        }
+
+        FILETIME created, accessed, written;
+        Handle hTimes(CreateFileW(native(src).c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ|FILE_SHARE_WRITE, nullptr,
+                                  OPEN_EXISTING, 0, nullptr));
+        if(hTimes.valid() && GetFileTime(hTimes, &created, &accessed, &written))
+            SetFileTime(hDst, &created, &accessed, &written);
+
+        return result;
+    }
@@ -0,0 +1,27 @@
+#ifndef COPYENGINE_H
+#define COPYENGINE_H
+
+#include <QString>
+#include <functional>
+
+/* Single file copy for Add (copy mode), cheapest method first:
+ *   Cloned:   block clone (FSCTL_DUPLICATE_EXTENTS_TO_FILE) when both files are on the same ReFS/Dev Drive volume:
+ *             no data is read or written, a 10 GB file is as fast as a small one
+ *   Copied:   CopyFileExW: the copy stays in the kernel (and uses offload on SMB/ODX storage)
+ *   Streamed: fallback when CopyFileExW refuses: overlapped, double-buffered read/write
+ * `progress` is called between chunks with bytes done and total; returning false cancels (dst is removed). */
+class CopyEngine
+{
+public:  enum Result { Failed, Cancelled, Cloned, Copied, Streamed };
+         typedef std::function<bool(const qint64 done, const qint64 total)> Progress;
+
+         static const qint64 CHUNK = 1024*1024,            // streaming buffer, 2 in flight
+                             UNBUFFERED = 256*1024*1024;    // above this, CopyFileExW bypasses the cache
+
+         static Result copy(const QString &src, const QString &dst, const Progress &progress=nullptr);
+
+private: static bool   clone (const QString &src, const QString &dst);
+         static Result stream(const QString &src, const QString &dst, const Progress &progress);
+};
+
+#endif // COPYENGINE_H
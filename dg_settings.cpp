@@ -2,6 +2,7 @@
 #include "_msgr.h"
 #include "config.h"
 #include "dg_settings.h"
+#include "modstore.h"
 
 #include <QFormLayout>
 #include <QLineEdit>
@@ -33,7 +34,11 @@ Settings::Settings(QWidget *parent, Config &cfg, Msgr *const msgr) : QDialog(par
 
             hideEmptyCbx = new QCheckBox(d::HIDE_EMPTY);
             formLayout->addRow(hideEmptyCbx);
-            hideEmptyCbx->setChecked(cfg.getSetting(Config::kHideEmpty) == Config::vOn);
+            hideEmptyCbx->setChecked(cfg.getFlag<Config::kHideEmpty>());
+
+            dedupCbx = new QCheckBox(d::DEDUP_ADDED_MODS);
+            formLayout->addRow(dedupCbx);
+            dedupCbx->setChecked(cfg.getFlag<Config::kDedupOnAdd>());
 
 
         QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
@@ -64,6 +69,8 @@ void Settings::accept()
     {
         cfg.saveSetting(Config::kGamePath, dirEdit->text().simplified());
         cfg.saveSetting(Config::kHideEmpty, hideEmptyCbx->isChecked() ? Config::vOn : Config::vOff);
+        cfg.saveSetting(Config::kDedupOnAdd, dedupCbx->isChecked() ? Config::vOn : Config::vOff);
+        ModStore::setDedupOnAdd(dedupCbx->isChecked());
         cfg.saveConfig();
 
         emit msgr->msg(d::SETTINGS_SAVED_, Msgr::Default);
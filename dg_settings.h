@@ -13,7 +13,7 @@ class Settings : public QDialog
     Q_OBJECT
 
                QLineEdit *dirEdit;
-               QCheckBox *hideEmptyCbx;
+               QCheckBox *hideEmptyCbx, *dedupCbx;
 
                Config &cfg;
                Msgr   *const msgr;
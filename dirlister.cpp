@@ -0,0 +1,55 @@
+#define WINVER _WIN32_WINNT_WIN7 //FIND_FIRST_EX_LARGE_FETCH and FindExInfoBasic need Windows 7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "dirlister.h"
+
+#include <windef.h>  // winbase.h needs to be
+#include <winbase.h> // preceded by windef.h
+#include <winnt.h>
+
+/********************************************************************/
+/*      DIR LISTER      *********************************************/
+/********************************************************************/
+    DirLister::DirLister(const QString &path) :
+        data(new WIN32_FIND_DATAW)
+    {
+        QString pattern = QString(path).replace('/', '\\')+"\\*";
+        if(pattern.length() >= MAX_PATH && pattern.at(1) == ':') pattern.prepend("\\\\?\\"); // long path, as QFileInfo does
+        handle = FindFirstFileExW(reinterpret_cast<LPCWSTR>(pattern.utf16()), FindExInfoBasic,
+                                  static_cast<WIN32_FIND_DATAW*>(data), FindExSearchNameMatch,
+                                  nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        pending = handle != INVALID_HANDLE_VALUE;
+    }
+
+    DirLister::~DirLister()
+    {
+        if(handle != INVALID_HANDLE_VALUE) FindClose(handle);
+        delete static_cast<WIN32_FIND_DATAW*>(data);
+    }
+
+    bool DirLister::next(Entry &entry)
+    {
+        WIN32_FIND_DATAW &fd = *static_cast<WIN32_FIND_DATAW*>(data);
+
+        for(; pending; pending = FindNextFileW(handle, &fd))
+        {
+            const wchar_t *name = fd.cFileName;
+            if(name[0] == L'.' && (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0'))) continue;
+
+            entry.name  = QString::fromWCharArray(name);
+            entry.dir   = fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+            entry.link  = (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT
+                           && (fd.dwReserved0 == IO_REPARSE_TAG_SYMLINK || fd.dwReserved0 == IO_REPARSE_TAG_MOUNT_POINT))
+                          || (!entry.dir && entry.name.endsWith(".lnk", Qt::CaseInsensitive)); // QFileInfo::isSymLink() does too
+            entry.size  = qint64(quint64(fd.nFileSizeHigh) << 32 | fd.nFileSizeLow);
+            entry.mtime = qint64((quint64(fd.ftLastWriteTime.dwHighDateTime) << 32 | fd.ftLastWriteTime.dwLowDateTime)
+                                 - 116444736000000000ULL) / 10000; // 100ns since 1601 -> ms since 1970
+
+            pending = FindNextFileW(handle, &fd);
+            return true;
+        }
+        return false;
+    }
@@ -0,0 +1,32 @@
+#ifndef DIRLISTER_H
+#define DIRLISTER_H
+
+#include <QString>
+
+/* Lists one folder with FindFirstFileExW: name, size, type and mtime come from the enumeration
+ * itself, so the scanners build no QFileInfo (and make no extra stat call) per plain file.
+ * FindExInfoBasic skips the 8.3 names, FIND_FIRST_EX_LARGE_FETCH asks for bigger batches.
+ * `.` and `..` are skipped; hidden and system entries are listed. */
+class DirLister
+{
+public:  struct Entry {
+             QString name;
+             qint64  size  = 0,
+                     mtime = 0;     // ms since epoch, same value as QFileInfo::lastModified()
+             bool    dir   = false,
+                     link  = false; // symlink, junction or .lnk: size/type of the target need a QFileInfo
+         };
+
+private: void *handle;
+         bool  pending;
+         void *data; // WIN32_FIND_DATAW of the entry not yet returned
+
+public:  explicit DirLister(const QString &path);
+         ~DirLister();
+         DirLister(const DirLister&) = delete;
+         DirLister &operator=(const DirLister&) = delete;
+
+         bool next(Entry &entry);
+};
+
+#endif // DIRLISTER_H
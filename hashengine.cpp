@@ -0,0 +1,124 @@
+#include "hashengine.h"
+
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+/* XXH64 (https://github.com/Cyan4973/xxHash), streaming form: same digests as the reference XXH64() */
+class Xxh64
+{
+    static constexpr quint64 P1 = 0x9E3779B185EBCA87ULL, P2 = 0xC2B2AE3D27D4EB4FULL, P3 = 0x165667B19E3779F9ULL,
+                             P4 = 0x85EBCA77C2B2AE63ULL, P5 = 0x27D4EB2F165667C5ULL;
+
+    quint64 v[4] = { P1+P2, P2, 0, 0-P1 }; // seed 0
+    quint64 total = 0;
+    uchar   buffer[32];
+    size_t  buffered = 0;
+
+    static quint64 rotl(const quint64 x, const int r) { return x << r | x >> (64-r); }
+    static quint64 read64(const uchar *p) { quint64 x; std::memcpy(&x, p, 8); return x; } // little endian only
+    static quint32 read32(const uchar *p) { quint32 x; std::memcpy(&x, p, 4); return x; }
+    static quint64 round(quint64 acc, const quint64 input) { return rotl(acc + input*P2, 31)*P1; }
+    static quint64 merge(const quint64 acc, const quint64 val) { return (acc ^ round(0, val))*P1 + P4; }
+
+    void stripe(const uchar *p)
+    { for(int i=0; i < 4; ++i) v[i] = round(v[i], read64(p+8*i)); }
+
+public:
+    void update(const uchar *p, size_t len)
+    {
+        total += len;
+        if(buffered+len < 32)
+        {
+            std::memcpy(buffer+buffered, p, len);
+            buffered += len;
+            return;
+        }
+
+        if(buffered)
+        {
+            const size_t fill = 32-buffered;
+            std::memcpy(buffer+buffered, p, fill);
+            stripe(buffer);
+            p += fill;
+            len -= fill;
+            buffered = 0;
+        }
+
+        for(; len >= 32; p += 32, len -= 32) stripe(p);
+
+        std::memcpy(buffer, p, len);
+        buffered = len;
+    }
+
+    quint64 digest() const
+    {
+        quint64 h;
+        if(total >= 32)
+        {
+            h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+            for(int i=0; i < 4; ++i) h = merge(h, v[i]);
+        }
+        else h = P5;
+        h += total;
+
+        const uchar *p = buffer;
+        size_t len = buffered;
+        for(; len >= 8; p += 8, len -= 8) h = rotl(h ^ round(0, read64(p)), 27)*P1 + P4;
+        if(len >= 4)
+        {
+            h = rotl(h ^ quint64(read32(p))*P1, 23)*P2 + P3;
+            p += 4;
+            len -= 4;
+        }
+        for(; len; ++p, --len) h = rotl(h ^ *p*P5, 11)*P1;
+
+        h ^= h >> 33;
+        h *= P2;
+        h ^= h >> 29;
+        h *= P3;
+        h ^= h >> 32;
+        return h;
+    }
+};
+}
+
+bool HashEngine::hashFile(File &file, QAtomicInteger<qint64> &done, const QAtomicInt &stop)
+{
+    QFile f(file.path);
+    if(!f.open(QIODevice::ReadOnly)) return false;
+
+    Xxh64 xxh;
+    const qint64 size = f.size();
+    for(qint64 offset=0; offset < size; offset += WINDOW)
+    {
+        if(stop.loadAcquire()) return false;
+
+        const qint64 len = std::min(WINDOW, size-offset);
+        if(uchar *view = f.map(offset, len)) // no copy: pages come straight from the file cache
+        {
+            xxh.update(view, size_t(len));
+            f.unmap(view);
+        }
+        else // some network shares and locked files: plain reads
+        {
+            if(!f.seek(offset)) return false;
+            const QByteArray &data = f.read(len);
+            if(data.size() != len) return false;
+            xxh.update(reinterpret_cast<const uchar*>(data.constData()), size_t(len));
+        }
+        done.fetchAndAddRelaxed(len);
+    }
+
+    file.size = size;
+    file.hash = xxh.digest();
+    file.ok   = true;
+    return true;
+}
+
+void HashJob::run()
+{
+    for(int i; !stop.loadAcquire() && (i = next.fetchAndAddRelaxed(1)) < int(files.size()); )
+        HashEngine::hashFile(files[size_t(i)], done, stop);
+}
@@ -0,0 +1,40 @@
+#ifndef HASHENGINE_H
+#define HASHENGINE_H
+
+#include <QString>
+#include <QRunnable>
+#include <QAtomicInteger>
+#include <vector>
+
+/* File hashing for Verify: XXH64 over memory-mapped views of the file, WINDOW bytes at a time
+ * (files that can't be mapped are read instead). HashJob runs it on all cores: every job takes
+ * the next file until there are none left, so one huge file doesn't hold up a batch of small ones. */
+class HashEngine
+{
+public:  struct File {
+             QString path;
+             qint64  size = 0;
+             quint64 hash = 0;
+             bool    ok   = false; // hashed; false: couldn't be read (or aborted before its turn)
+         };
+         static constexpr qint64 WINDOW = 64*1024*1024;
+
+         // done: bytes hashed so far, for progress; stop: checked between windows
+         static bool hashFile(File &file, QAtomicInteger<qint64> &done, const QAtomicInt &stop);
+};
+
+class HashJob : public QRunnable
+{
+               std::vector<HashEngine::File> &files;
+               QAtomicInt                    &next;
+               const QAtomicInt              &stop;
+               QAtomicInteger<qint64>        &done;
+
+public:        HashJob(std::vector<HashEngine::File> &files, QAtomicInt &next, const QAtomicInt &stop,
+                       QAtomicInteger<qint64> &done)
+                   : files(files), next(next), stop(stop), done(done) {}
+
+               void run() override;
+};
+
+#endif // HASHENGINE_H
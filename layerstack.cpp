@@ -0,0 +1,80 @@
+#include "layerstack.h"
+#include "conflictindex.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+const QString LayerStack::DIR       = ".layers",
+              LayerStack::SEPARATOR = "+";
+
+const quint32 LayerStack::MAGIC   = 0x574d4d4c, // "WMML"
+              LayerStack::VERSION = 1;
+
+/********************************************************************/
+/*      LAYER STACK     *********************************************/
+/********************************************************************/
+    bool LayerStack::load(const QString &pathMods, const QString &name)
+    {
+        QFile file(root(pathMods, name)+".wmml");
+        if(!file.open(QIODevice::ReadOnly)) return false;
+
+        QDataStream in(&file);
+        quint32 magic, version, count;
+        in >> magic >> version;
+        if(magic != MAGIC || version != VERSION) return false;
+
+        QStringList loadedLayers;
+        in >> loadedLayers >> count;
+
+        std::unordered_map<QString, Link> loaded;
+        loaded.reserve(count);
+        for(quint32 i=0; i < count && in.status() == QDataStream::Ok; ++i)
+        {
+            Link link;
+            quint8 kind;
+            in >> link.rel >> link.src >> kind;
+            link.kind = Overlay::Kind(kind);
+            loaded.insert({ ConflictIndex::fold(link.rel), std::move(link) });
+        }
+
+        if(in.status() != QDataStream::Ok) return false; // truncated: the farm is relinked from scratch
+        layers = std::move(loadedLayers);
+        links  = std::move(loaded);
+        return true;
+    }
+
+    bool LayerStack::save(const QString &pathMods, const QString &name) const
+    {
+        QSaveFile file(root(pathMods, name)+".wmml");
+        if(!file.open(QIODevice::WriteOnly)) return false;
+
+        QDataStream out(&file);
+        out << MAGIC << VERSION << layers << quint32(links.size());
+        for(const std::pair<const QString, Link> &link : links)
+            out << link.second.rel << link.second.src << quint8(link.second.kind);
+
+        return file.commit();
+    }
+
+/********************************************************************/
+/*      LAYER JOB       *********************************************/
+/********************************************************************/
+    void LayerJob::run()
+    {
+        for(size_t i=begin; i < end && !stop.loadAcquire(); ++i)
+        {
+            LayerStack::Link &link = *links[i];
+            const QString &dst = root+"/"+link.rel;
+
+            if(unlinking) results[i] = Overlay::unlink(link.src, dst, link.kind);
+            else
+            {
+                QDir().mkpath(QFileInfo(dst).absolutePath()); // another job making the same folder is fine
+                results[i] = Overlay::link(link.src, dst, true, link.kind); // farm and layers share the mods folder
+            }
+            done.ref();
+        }
+    }
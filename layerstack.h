@@ -0,0 +1,54 @@
+#ifndef LAYERSTACK_H
+#define LAYERSTACK_H
+
+#include "_uo_map_qs.h"
+#include "overlay.h"
+#include <QStringList>
+
+/* Layered mount: several mod folders seen as one, the higher layer winning wherever two provide the same path
+ * (compared the way the game does, see ConflictIndex::fold). The merged view is a link farm in
+ * mods/.layers/<stack name>, which war3mod.mpq links to like any mod folder. The farm stays after Unmount:
+ * its manifest (<stack name>.wmml) records what every link points at, so mounting the same stack again only
+ * relinks what changed in the layers since. */
+class LayerStack
+{
+public:  static const QString DIR,        // in the mods folder, skipped when listing mods
+                              SEPARATOR;  // between layer names in the stack name
+
+         struct Link {
+             QString       rel, src;      // rel: in the farm, as the winning layer spells it
+             Overlay::Kind kind = Overlay::SymLink;
+         };
+
+         QStringList layers;                      // bottom first
+         std::unordered_map<QString, Link> links; // folded rel -> link
+
+private: static const quint32 MAGIC, VERSION;
+
+public:  static QString name(const QStringList &layers) { return layers.join(SEPARATOR); }
+         static QString root(const QString &pathMods, const QString &name) { return pathMods+"/"+DIR+"/"+name; }
+
+         bool load(const QString &pathMods, const QString &name);       // false: never materialised, or unreadable
+         bool save(const QString &pathMods, const QString &name) const;
+};
+
+/* Makes or removes links [begin, end) of a farm; each job only writes its own range of `results` */
+class LayerJob : public QRunnable
+{
+               const std::vector<LayerStack::Link *> &links;
+               std::vector<Overlay::Result>          &results;
+               const QString                         root;
+               const size_t                          begin, end;
+               const bool                            unlinking;
+               QAtomicInt                            &stop, &done;
+
+public:        LayerJob(const std::vector<LayerStack::Link *> &links, std::vector<Overlay::Result> &results,
+                        const QString &root, const size_t begin, const size_t end, const bool unlinking,
+                        QAtomicInt &stop, QAtomicInt &done)
+                   : links(links), results(results), root(root), begin(begin), end(end), unlinking(unlinking),
+                     stop(stop), done(done) {}
+
+               void run() override;
+};
+
+#endif // LAYERSTACK_H
@@ -1,20 +1,24 @@
 #include "_dic.h"
+#include "_timeline.h"
 #include "main_core.h"
 #include "main_launcher.h"
 #include "mainwindow.h"
+#include "thread.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
+    Timeline::start();
     QApplication a(argc, argv);
     a.setAttribute(Qt::AA_DisableWindowContextHelpButton);
 
-    qRegisterMetaType<md::data>("md::data");
-    qRegisterMetaType<md::modData>("md::modData");
+    qRegisterMetaType<md::Registry>("md::Registry");
+    qRegisterMetaType<md::Diff>("md::Diff");
     qRegisterMetaType<Msgr::Type>("Msgr::Type");
 
+    Timeline::mark("application");
     Core core;
 
     const QStringList args = a.arguments();
@@ -24,21 +28,38 @@ int main(int argc, char *argv[])
         parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
         parser.addHelpOption();
         parser.addOptions({
-            QCommandLineOption({ d::C_LAUNCH },
+            QCommandLineOption(d::C_LAUNCH,
                                QStringLiteral(u"%0 to %1. Enter \"%2\" (including double-quotes) to %1 without %3 (default).")
                                 .arg(d::MOD, d::C_LAUNCH, d::L_NONE, d::lMOD),
                                d::lMOD),
-            QCommandLineOption({ d::C_VERSION },
+            QCommandLineOption(d::C_VERSION,
                                QStringLiteral(u"%0: [%1|%2|%3].")
                                 .arg(d::GAME_VERSION, d::V_CLASSIC, d::V_EXPANSION, d::V_WE),
                                d::C_VERSION),
-            QCommandLineOption({ d::C_NATIVE },
+            QCommandLineOption(d::C_NATIVE,
                                QStringLiteral(u"Supply %0 %1 command line %2. Ignored when %3.")
                                 .arg(d::C_NATIVE, d::WC3_EXE, d::lARGUMENTS, d::lLAUNCHING_X.arg(d::WE)),
-                               d::lARGUMENTS)
+                               d::lARGUMENTS),
+            QCommandLineOption(d::C_VERIFY,
+                               QStringLiteral(u"%0 to %1, or \"%2\" for all %3, then exit (1: changed or missing files, see verify.log).")
+                                .arg(d::MOD, d::C_VERIFY, d::L_ALL, d::lMODS),
+                               d::lMOD)
         });
         parser.parse(args);
 
+        if(!parser.value(d::C_VERIFY).isEmpty()) // unattended (eg. a nightly task): no launch, no main window
+        {
+            const QString &modName = parser.value(d::C_VERIFY);
+            const bool all = modName == d::L_ALL;
+            core.closeSplash();
+
+            Thread *thr = new Thread(ThreadAction::Verify, all ? d::lALL_MODS : modName, core.cfg.pathMods);
+            QObject::connect(thr, &Thread::resultReady, &a, [&a](const ThreadAction &action) { a.exit(action.errors()); });
+            thr->start(all ? core.modNames().join('/') : modName);
+
+            return a.exec();
+        }
+
         if(!parser.value(d::C_LAUNCH).isEmpty() || !parser.value(d::C_VERSION).isEmpty()
                 || !parser.value(d::C_NATIVE).isEmpty())
         {
@@ -49,6 +70,7 @@ int main(int argc, char *argv[])
     }
 
     MainWindow w(&core);
+    Timeline::mark("window");
     w.show();
 
     return a.exec();
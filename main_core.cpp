@@ -1,5 +1,14 @@
 #include "_dic.h"
+#include "_throttle.h"
+#include "_timeline.h"
 #include "thread.h"
+#include "backupmanifest.h"
+#include "overlay.h"
+#include "modstore.h"
+#include "modmanifest.h"
+#include "reaper.h"
+#include "mpqarchive.h"
+#include "layerstack.h"
 #include "main_core.h"
 
 #include <QSplashScreen>
@@ -11,6 +20,7 @@
 #include <QUrl>
 #include <QProcess>
 #include <QFileInfo>
+#include <QDirIterator>
 
 #include <winerror.h>
 
@@ -24,6 +34,14 @@ Core::Core() : QObject(),
 {
     qRegisterMetaType<ThreadAction>("ThreadAction");
 
+    Throttle::setDefaults(int(cfg.getNumber<Config::kProgressMs>()), int(cfg.getNumber<Config::kProgressFiles>()));
+    BackupManifest::setPath(cfg.pathBackups);
+    Overlay::setPath(cfg.pathOverlay);
+    ModStore::setPath(cfg.pathMods);
+    ModManifest::setPath(cfg.pathManifests);
+    ModStore::setDedupOnAdd(cfg.getFlag<Config::kDedupOnAdd>());
+    Timeline::mark("config");
+
     splashScreen->setAttribute(Qt::WA_DeleteOnClose);
 
     QLabel *vrsLbl = new QLabel(splashScreen);
@@ -34,8 +52,7 @@ Core::Core() : QObject(),
 
     showMsg(d::STARTING___, Msgr::Busy);
     splashScreen->show();
-
-    mountedMod = getMounted();
+    Timeline::mark("splash"); // the mounted mod is looked up by whoever needs it: MainWindow::refresh, Launcher
 }
 
 Core::~Core()
@@ -51,24 +68,10 @@ void Core::closeSplash(QWidget *finish)
 {
     if(splashScreen)
     {
-        QCoreApplication::processEvents();
-
-        finishWgt = finish;
-        QTimer::singleShot(2000-bool(finish)*1000, this, SLOT(closeSplashTimed()));
-
-        QCoreApplication::processEvents();
-    }
-}
-
-void Core::closeSplashTimed()
-{
-    if(finishWgt)
-    {
-        splashScreen->finish(finishWgt);
-        finishWgt = nullptr;
+        if(finish) splashScreen->finish(finish); // once `finish` is on screen
+        else splashScreen->close();
+        splashScreen = nullptr;
     }
-    else splashScreen->close();
-    splashScreen = nullptr;
 }
 
 void Core::showMsg(const QString &_msg, const Msgr::Type &msgType, const bool propagate)
@@ -96,11 +99,27 @@ void Core::showMsg(const QString &_msg, const Msgr::Type &msgType, const bool pr
 
 QString Core::getMounted()
 {
+    const QString &overlayMod = Overlay::mountedMod();
+    if(!overlayMod.isEmpty()) return overlayMod;
+
     const QFileInfo &fiMounted(cfg.getSetting(Config::kGamePath)+"/"+md::w3mod);
 
-    return fiMounted.exists() && fiMounted.isDir() ? fiMounted.isSymLink() ? QFileInfo(fiMounted.symLinkTarget()).fileName()
-                                                                           : md::unknownMod
-                                                   : QString();
+    return fiMounted.exists() && (fiMounted.isDir() || MpqArchive::isArchive(fiMounted.absoluteFilePath()))
+           ? fiMounted.isSymLink() ? QFileInfo(fiMounted.symLinkTarget()).fileName()
+                                   : md::unknownMod
+           : QString();
+}
+
+QStringList Core::modNames() const
+{
+    QStringList modNames;
+    for(QDirIterator itMods(cfg.pathMods, QDir::NoDotAndDotDot|QDir::Dirs|QDir::Files|QDir::NoSymLinks); itMods.hasNext(); )
+    {
+        itMods.next();
+        if(itMods.fileName() != Reaper::TRASH && itMods.fileName() != ModStore::DIR && itMods.fileName() != LayerStack::DIR
+           && (itMods.fileInfo().isDir() || MpqArchive::isPacked(itMods.fileName()))) modNames << itMods.fileName();
+    }
+    return modNames;
 }
 
 void Core::launch(const bool editor, const QString &args)
@@ -229,7 +248,7 @@ bool Core::actionDone(const ThreadAction &action)
 
 QString Core::a2s(const ThreadAction &action)
 {
-    const d::ac_t &dac = d::ac.find(action.PROCESSING)->second;
+    const d::ac_t &dac = d::ac[action.action];
     return QStringLiteral(u"%0.%1").arg(
        /* %0 */ action.aborted()           ? d::X_ABORTED.arg(action.PROCESSING+" "+action.modName+": ")
                 : !action.filesProcessed() ? d::NO_FILES_TO_X.arg(dac[size_t(d::Ac::lPROCESS)])
@@ -247,7 +266,7 @@ QString Core::a2s(const ThreadAction &action)
 
 QString Core::a2e(const ThreadAction &action)
 {
-    const d::ac_t &dac = d::ac.find(action.PROCESSING)->second;
+    const d::ac_t &dac = d::ac[action.action];
     return QStringLiteral(u"%0: %1%2%3").arg(
    /* %0 */   action.aborted()           ? d::X_ABORTED.arg(action.PROCESSING)
               //: action.forced()          ? d::FORCE_X.arg(dac[size_t(d::Ac::lPROCESS)])
@@ -5,6 +5,7 @@
 #include "config.h"
 
 #include <QPixmap>
+#include <QStringList>
 
 class ThreadAction;
 class Thread;
@@ -25,7 +26,6 @@ public:        enum MountResult { MountReady, Mounted, MountFailed, OtherMounted
                QString mountedMod;
                               
 private:       QSplashScreen *splashScreen;
-               QWidget *finishWgt=nullptr;
                bool setGameVersion = true ;
 
 public:        Config cfg;
@@ -33,12 +33,12 @@ public:        Config cfg;
                Core();
                ~Core();
 
-               void closeSplash(QWidget *finish=nullptr);
-private slots: void closeSplashTimed();
+               void closeSplash(QWidget *finish=nullptr); // as soon as `finish` is up, or now
 signals:       void msg    (const QString &msg, const Msgr::Type &msgType=Msgr::Default);
 public:        void showMsg(const QString &msg, const Msgr::Type &msgType=Msgr::Default, const bool propagate=true);
                
                QString getMounted();
+               QStringList modNames() const; // mod folders, for -verify <all>
 
 public slots:  void launch(const bool editor=false, const QString &args=QString());
 
@@ -13,6 +13,7 @@ Launcher::Launcher(Core *const core, const QString &_modName, const QString &ver
     core->setParent(this);
 
     core->showMsg(d::PROCESSING_ARGUMENTS___, Msgr::Busy);
+    core->mountedMod = core->getMounted();
 
     bool doLaunch = true;
 
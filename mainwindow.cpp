@@ -1,6 +1,15 @@
 #include "_dic.h"
 #include "_utils.h"
+#include "_timeline.h"
 #include "thread.h"
+#include "scanengine.h"
+#include "modwatcher.h"
+#include "reaper.h"
+#include "backupmanifest.h"
+#include "modstore.h"
+#include "modmanifest.h"
+#include "overlay.h"
+#include "layerstack.h"
 #include "main_core.h"
 #include "mainwindow.h"
 #include "dg_shortcuts.h"
@@ -11,8 +20,10 @@
 #include <QLayout>
 #include <QCheckBox>
 #include <QPushButton>
-#include <QTableWidget>
 #include <QHeaderView>
+#include <QPainter>
+#include <QStyle>
+#include <QApplication>
 #include <QStatusBar>
 #include <QLabel>
 #include <QDirIterator>
@@ -21,17 +32,160 @@
 #include <QDesktopServices>
 #include <QDialogButtonBox>
 #include <QTimer>
+#include <QThread>
 #include <QLineEdit>
+#include <QListWidget>
 
 #include <winerror.h>
 
 #include <QDebug>
 
+/********************************************************************/
+/*      MOD MODEL       *********************************************/
+/********************************************************************/
+    QVariant ModModel::data(const QModelIndex &index, int role) const
+    {
+        if(!index.isValid() || index.row() >= registry.count()) return QVariant();
+
+        const int row = index.row();
+        switch(role)
+        {
+        case Qt::DisplayRole:
+            return index.column() == Name ? registry.name(row)
+                 : index.column() == Size ? ThreadBase::getMB(registry.size(row))
+                                          : d::X_FILES.arg(registry.fileCount(row));
+        case Qt::ToolTipRole: // linked files count in full towards the size: tell what is this mod's alone
+            if(index.column() == Files)
+                return registry.linkCount(row) ? QVariant(d::X_FILES_THROUGH_LINKS.arg(registry.linkCount(row))) : QVariant();
+            if(index.column() != Size) return QVariant();
+            return d::X_APPARENT_X_UNIQUE.arg(ThreadBase::getMB(registry.size(row)),
+                                              ThreadBase::getMB(ModStore::shared().uniqueBytes(registry.name(row),
+                                                                                               registry.size(row))));
+        case Qt::TextAlignmentRole:
+            return int(Qt::AlignVCenter|(index.column() == Size ? Qt::AlignRight : Qt::AlignLeft));
+        case MountedRole:
+            return !mountedMod.isEmpty() && registry.name(row) == mountedMod;
+        default:
+            return QVariant();
+        }
+    }
+
+    QVariant ModModel::headerData(int section, Qt::Orientation orientation, int role) const
+    {
+        if(orientation == Qt::Horizontal)
+        {
+            if(role == Qt::DisplayRole)
+                return (section == Name ? d::MOD : section == Size ? d::SIZE : d::FILES).toString();
+            else if(role == Qt::TextAlignmentRole)
+                return int(Qt::AlignVCenter|(section == Size ? Qt::AlignRight : Qt::AlignLeft));
+        }
+        return QVariant();
+    }
+
+    void ModModel::insertMod(const QString &modName, const int row, const bool busy)
+    {
+        beginInsertRows(QModelIndex(), row, row);
+        registry.insert(modName, row, busy);
+        endInsertRows();
+    }
+
+    void ModModel::placeMod(const QString &modName, const int first)
+    {
+        const int from = row(modName);
+        if(from < first) return;
+
+        const int to = registry.sortedRow(modName, first, from);
+        if(to != from && beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to+1 : to))
+        {
+            registry.move(from, to);
+            endMoveRows();
+        }
+    }
+
+    void ModModel::removeMod(const QString &modName)
+    {
+        const int row = this->row(modName);
+        if(row >= 0)
+        {
+            beginRemoveRows(QModelIndex(), row, row);
+            registry.remove(modName);
+            endRemoveRows();
+        }
+    }
+
+    void ModModel::renameMod(const QString &modName, const QString &newName)
+    {
+        const int row = this->row(modName);
+        if(row >= 0 && registry.rename(modName, newName))
+        {
+            if(mountedMod == modName) mountedMod = newName;
+
+            emit dataChanged(index(row, Name), index(row, Name), { Qt::DisplayRole });
+        }
+    }
+
+    void ModModel::updateMod(const QString &modName, const qint64 size, const int fileCount, const int links)
+    {
+        const int row = registry.update(modName, size, fileCount, links);
+        if(row >= 0)
+        {
+            emit dataChanged(index(row, Size), index(row, Files), { Qt::DisplayRole });
+        }
+    }
+
+    void ModModel::setMounted(const QString &modName)
+    {
+        if(modName != mountedMod)
+        {
+            const int oldRow = row(mountedMod);
+            mountedMod = modName;
+            const int newRow = row(mountedMod);
+
+            if(oldRow >= 0) emit dataChanged(index(oldRow, 0), index(oldRow, Column_Size-1), { MountedRole });
+            if(newRow >= 0) emit dataChanged(index(newRow, 0), index(newRow, Column_Size-1), { MountedRole });
+        }
+    }
+
+/********************************************************************/
+/*      MOD DELEGATE        *****************************************/
+/********************************************************************/
+    void ModDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+    {
+        if(!index.data(ModModel::MountedRole).toBool())
+        {
+            QStyledItemDelegate::paint(painter, option, index);
+            return;
+        }
+
+        // Mounted mod: dashed yellow frame around the whole row, dark background
+        QStyleOptionViewItem opt(option);
+        initStyleOption(&opt, index);
+        opt.state &= ~(QStyle::State_Selected|QStyle::State_HasFocus);
+        opt.backgroundBrush = QColor("#555");
+        opt.palette.setColor(QPalette::Text, QColor("#eee"));
+
+        const QWidget *widget = option.widget;
+        (widget ? widget->style() : QApplication::style())->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+        painter->save();
+        painter->setPen(QPen(QColor("#f7f500"), 2, Qt::DashLine));
+        const QRect &r = opt.rect.adjusted(1, 1, -1, -1);
+        painter->drawLine(r.topLeft(),    r.topRight());
+        painter->drawLine(r.bottomLeft(), r.bottomRight());
+        if(index.column() == 0) painter->drawLine(r.topLeft(), r.bottomLeft());
+        if(index.column() == index.model()->columnCount()-1) painter->drawLine(r.topRight(), r.bottomRight());
+        painter->restore();
+    }
+
 /********************************************************************/
 /*      MOD TABLE       *********************************************/
 /********************************************************************/
-    ModTable::ModTable() : QTableWidget(0, 3)
+    ModTable::ModTable() : QTableView(),
+        mods(new ModModel(this))
     {
+        setModel(mods);
+        setItemDelegate(new ModDelegate(this));
+
         setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
         setContextMenuPolicy(Qt::ActionsContextMenu);
         setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -39,117 +193,75 @@
         setAlternatingRowColors(true);
         setSelectionMode(QAbstractItemView::SingleSelection);
         setSelectionBehavior(QAbstractItemView::SelectRows);
+        setShowGrid(false);
+        setWordWrap(false);
         QFont tableFont = font();
         tableFont.setPointSizeF(tableFont.pointSize()*1.2);
         setFont(tableFont);
 
             verticalHeader()->hide();
-            setHorizontalHeaderLabels({ d::MOD, d::SIZE, d::FILES });
+            verticalHeader()->setSectionResizeMode(QHeaderView::Fixed); // uniform rows: no per-row resize
+            verticalHeader()->setDefaultSectionSize(fontMetrics().height()+6);
             horizontalHeader()->setStretchLastSection(true);
-            horizontalHeaderItem(0)->setTextAlignment(Qt::AlignVCenter|Qt::AlignLeft);
-            horizontalHeaderItem(1)->setTextAlignment(Qt::AlignVCenter|Qt::AlignRight);
-            horizontalHeaderItem(2)->setTextAlignment(Qt::AlignVCenter|Qt::AlignLeft);
     }
 
-    QLabel* ModTable::cellLabel(const int row, const int column) const
-    { return dynamic_cast<QLabel *>(cellWidget(row, column)); }
-
-    void ModTable::resizeCR(const int row)
+    void ModTable::resizeCR()
     {
-        resizeColumnToContents(0);
-        resizeColumnToContents(1); // Last column (2) is stretched
-        if(row >=0 && row < rowCount()) resizeRowToContents(row);
+        resizeColumnToContents(ModModel::Name);
+        resizeColumnToContents(ModModel::Size); // Last column (Files) is stretched
     }
 
-    void ModTable::addMod(const QString &modName, const int row, const bool addData)
-    {
-        if(addData)
-        {
-            modNames.insert(row, modName);
-            modData.insert({ modName, md::newData(row) });
-            for(int i=row+1; i < modNames.length(); ++i) // Renumber mods following added
-                md::setRow(modData[modNames[i]], i);
-        }
+    void ModTable::fitColumn(const int row, const ModModel::Column column)
+    {   // grow only, one cell: avoids a full resizeColumnToContents() pass per update
+        const int width = itemDelegate()->sizeHint(viewOptions(), mods->index(row, column)).width();
+        if(width > columnWidth(column)) setColumnWidth(column, width);
+    }
 
-        insertRow(row);
+    void ModTable::addMod(const QString &modName, const int row)
+    {
+        if(this->row(modName) >= 0) return; // already listed by a refresh
 
-        QLabel *nameLbl = new QLabel(modName),
-               *sizeLbl = new QLabel(d::ZERO_MB),
-               *filesLbl = new QLabel(d::ZERO_FILES);
-        nameLbl->setContentsMargins(3, 0, 3, 0);
-        setCellWidget(row, 0, nameLbl);
-        sizeLbl->setContentsMargins(3, 0, 3, 0);
-        sizeLbl->setAlignment(Qt::AlignVCenter|Qt::AlignRight);
-        setCellWidget(row, 1, sizeLbl);
-        filesLbl->setContentsMargins(3, 0, 3, 0);
-        setCellWidget(row, 2, filesLbl);
-        resizeCR(row);
+        mods->insertMod(modName, row);
+        fitColumn(row, ModModel::Name);
+        fitColumn(row, ModModel::Size);
     }
 
     void ModTable::deleteMod(const QString &modName)
     {
-        if(md::exists(modData, modName))
+        if(row(modName) >= 0)
         {
-            const int row = this->row(modName);
-
-            modNames.removeAt(row);
-            modData.erase(modName);
-            for(int i=row; i < modNames.length(); ++i) // Renumber mods following deleted
-                md::setRow(modData[modNames[i]], i);
-
-            removeRow(row);
+            mods->removeMod(modName);
             resizeCR();
         }
     }
 
-    void ModTable::updateMod(const QString &modName, const QString &modSize, const QString &fileCount, const qint64 size)
+    void ModTable::updateMod(const QString &modName, const qint64 size, const int fileCount, const int links)
     {
-        if(md::exists(modData, modName))
+        const int row = this->row(modName);
+        if(row >= 0)
         {
-            const int row = this->row(modName);
-
-            QLabel *sizeLbl = cellLabel(row, 1),
-                   *fileLbl = cellLabel(row, 2);
-
-            const QString &oldSize = sizeLbl->text(),
-                          &oldCount = fileLbl->text();
+            const bool wasEmpty = mods->registry.size(row) <= 0 && mods->registry.fileCount(row) == 0;
+            bool focus = !hasFocus() && currentRow() == row;
 
-            bool resize = oldSize.length() != modSize.length() || oldCount.length() != fileCount.length(),
-                 focus = !hasFocus() && currentRow() == row;
-            
-            setSize(modName, size);
-            sizeLbl->setText(modSize);
-            fileLbl->setText(fileCount);
+            mods->updateMod(modName, size, fileCount, links);
 
             if(isRowHidden(row))
             {
-                if(modSize != d::ZERO_MB || fileCount != d::ZERO_FILES)
-                {
-                    showRow(row);
-                    resize = true;
-                }
+                if(size > 0 || fileCount != 0) showRow(row);
                 else focus = false;
             }
-            else focus = focus && oldSize == d::ZERO_MB && oldCount == d::ZERO_FILES;
+            else focus = focus && wasEmpty;
 
-            if(resize) resizeCR(row);
+            fitColumn(row, ModModel::Size);
             if(focus) setFocus();
         }
     }
 
     void ModTable::renameMod(const QString &modName, const QString &newName)
     {
-        if(md::exists(modData, modName))
+        if(row(modName) >= 0)
         {
-            const int row = this->row(modName);
-
-            modNames[row] = newName;
-
-            const md::data &data = modData[modName];
-            modData.erase(modName);
-            modData.insert({ newName, data });
-
-            cellLabel(row, 0)->setText(newName);
+            mods->renameMod(modName, newName);
             resizeCR();
         }
     }
@@ -159,9 +271,9 @@
 /********************************************************************/
 MainWindow::MainWindow(Core *const core) : QMainWindow(),
     core(core),
-    gameIcons({ u::largestIcon(QIcon(":/icons/war3.ico")),      u::largestIcon(QIcon(":/icons/war3x.ico")),
-                u::largestIcon(QIcon(":/icons/war3_mod.ico")),  u::largestIcon(QIcon(":/icons/war3x_mod.ico")) }),
-    editIcons({ u::largestIcon(QIcon(":/icons/worldedit.ico")), u::largestIcon(QIcon(":/icons/worldedit_mod.ico")) })
+    scanEngine(new ScanEngine(core->cfg.pathIndex, this)),
+    modWatcher(new ModWatcher(this)),
+    reaper(new Reaper(core->cfg.pathMods, this))
 {
     core->setParent(this);
     msgr.setParent(this);
@@ -182,10 +294,13 @@ MainWindow::MainWindow(Core *const core) : QMainWindow(),
             QAction *acOpenGameFolder = new QAction(d::OPEN_X.arg(d::X_FOLDER).arg(d::aX).arg(d::GAME)),
                     *acOpenModsFolder = new QAction(d::OPEN_X.arg(d::X_FOLDER).arg(d::aX).arg(d::MODS)),
                     *acOpenShortcuts  = new QAction(d::aX.arg(d::CREATE_uSHORTCUTS)),
+                    *acCleanBackups   = new QAction(d::aX.arg(d::CLEAN_UP_uBACKUPS)),
+                    *acDedupAll       = new QAction(d::aX.arg(d::DEDUPLICATE_ALL_uMODS)),
+                    *acVerifyAll      = new QAction(d::aX.arg(d::VERIFY_ALL_uMODS)),
                     *acOpenSettings   = new QAction(d::aX.arg(d::SETTINGS)),
                     *acOpenAbout      = new QAction(d::aX.arg(d::ABOUT));
             fileMenu->addActions({ acOpenGameFolder, acOpenModsFolder });
-            toolsMenu->addActions({ acOpenShortcuts, acOpenSettings });
+            toolsMenu->addActions({ acOpenShortcuts, acCleanBackups, acDedupAll, acVerifyAll, acOpenSettings });
             aboutMenu->addAction(acOpenAbout);
 
     // TOOLBARS
@@ -236,11 +351,18 @@ MainWindow::MainWindow(Core *const core) : QMainWindow(),
     modTable = new ModTable;
     setCentralWidget(modTable);
 
-                toggleMountAc = new QAction;
+                toggleMountAc  = new QAction;
+                overlayMountAc = new QAction(d::MOUNT_AS_aOVERLAY);
+                layeredMountAc = new QAction(d::MOUNT_aLAYERED___);
         QAction *actionOpen   = new QAction(d::OPEN_X.arg(d::FOLDER)),
                 *actionRename = new QAction(d::RENAME),
+                *actionDedup  = new QAction(d::DEDUPLICATE),
+                *actionVerify = new QAction(d::VERIFY),
+                *actionPack   = new QAction(d::PACK),
+                *actionConflicts = new QAction(d::CONFLICTS),
                 *actionDelete = new QAction(d::dDELETE);
-        modTable->addActions({ toggleMountAc, actionOpen, actionRename, actionDelete });
+        modTable->addActions({ toggleMountAc, overlayMountAc, layeredMountAc, actionOpen, actionRename, actionDedup, actionVerify, actionPack,
+                               actionConflicts, actionDelete });
 
     // STATUSBAR
     setStatusBar(new QStatusBar);
@@ -250,8 +372,8 @@ MainWindow::MainWindow(Core *const core) : QMainWindow(),
         statusLbl = new QLabel;
         statusBar()->addWidget(statusLbl);
 
-    // initialize conditional UI & fetch mods
-    refresh(true);
+    // conditional UI & mods: see show()
+    QTimer::singleShot(0, reaper, &Reaper::reap); // tombstones of deletes the last run didn't finish
 
     // MESSAGES
     connect(core,  &Core::msg, this, &MainWindow::showStatus);
@@ -261,6 +383,9 @@ MainWindow::MainWindow(Core *const core) : QMainWindow(),
     connect(acOpenGameFolder, &QAction::triggered, this, &MainWindow::openGameFolder);
     connect(acOpenModsFolder, &QAction::triggered, this, &MainWindow::openModsFolder);
     connect(acOpenShortcuts,  &QAction::triggered, this, &MainWindow::openShortcuts);
+    connect(acCleanBackups,   &QAction::triggered, this, &MainWindow::cleanBackups);
+    connect(acDedupAll,       &QAction::triggered, this, &MainWindow::dedupAll);
+    connect(acVerifyAll,      &QAction::triggered, this, &MainWindow::verifyAll);
     connect(acOpenSettings,   &QAction::triggered, this, &MainWindow::openSettings);
     connect(acOpenAbout,      &QAction::triggered, this, &MainWindow::openAbout);
     // TOOLBAR
@@ -271,16 +396,34 @@ MainWindow::MainWindow(Core *const core) : QMainWindow(),
     connect(addModBtn,      &QPushButton::clicked, this, &MainWindow::addMod);
     connect(refreshBtn,     SIGNAL(clicked()),           SLOT(refresh()));
     // MOD LIST
+    connect(overlayMountAc, &QAction::triggered, this, &MainWindow::mountModOverlay);
+    connect(layeredMountAc, &QAction::triggered, this, &MainWindow::mountLayered);
     connect(actionOpen,   &QAction::triggered, this, &MainWindow::openModFolder);
     connect(actionRename, &QAction::triggered, this, &MainWindow::renameMod);
+    connect(actionDedup,  &QAction::triggered, this, &MainWindow::dedupMod);
+    connect(actionVerify, &QAction::triggered, this, &MainWindow::verifyMod);
+    connect(actionPack,   &QAction::triggered, this, &MainWindow::packMod);
+    connect(actionConflicts, &QAction::triggered, this, &MainWindow::showConflicts);
     connect(actionDelete, &QAction::triggered, this, &MainWindow::deleteMod);
+    // SCAN
+    connect(scanEngine, &ScanEngine::scanModUpdate, modTable, &ModTable::updateMod);
+    connect(scanEngine, &ScanEngine::scanModReady,  this,     &MainWindow::scanModDone);
+    // WATCHER
+    connect(modWatcher, &ModWatcher::modsChanged,  this, [this]{ refresh(true); });
+    connect(modWatcher, &ModWatcher::modChanged,   this, &MainWindow::rescanMod);
+    connect(modWatcher, &ModWatcher::mountChanged, this, [this]
+    {
+        gameScanned.clear();
+        if(core->getMounted() != core->mountedMod) refresh(true);
+        else scanGame();
+    });
 }
 
 void MainWindow::show()
 {
     QMainWindow::show();
-    showMsg(d::READY_, Msgr::Permanent);
-    core->closeSplash(this);
+    Timeline::mark("shown");
+    QTimer::singleShot(0, this, [this]{ refresh(true); }); // after the first paint; the splash stays up until scanMods
 }
 
 void MainWindow::showStatus(const QString &msg, const Msgr::Type &msgType)
@@ -299,10 +442,10 @@ void MainWindow::showMsg(const QString &msg, const Msgr::Type &msgType)
 
 bool MainWindow::tryBusy(const QString &modName)
 {
-    const bool exists = md::exists(modTable->modData, modName);
-    if(!exists || !md::busy(modTable->modData[modName]))
+    const bool exists = modTable->mods->registry.contains(modName);
+    if(!exists || !modTable->mods->registry.isBusy(modName))
     {
-        if(exists) std::get<int(md::Busy)>(modTable->modData[modName]) = true;
+        if(exists) modTable->mods->setBusy(modName, true);
         return true;
     }
     else
@@ -326,10 +469,15 @@ void MainWindow::updateLaunchBtns()
     const bool modEnabled = !core->mountedMod.isEmpty(),
                exp = gameVersionCbx->isChecked();
 
-    launchGameAc->setIcon(gameIcons[size_t(modEnabled<<1)|exp]);
+    static const std::array<const QString, 4> gamePaths = { ":/icons/war3.ico",     ":/icons/war3x.ico",
+                                                            ":/icons/war3_mod.ico", ":/icons/war3x_mod.ico" };
+    static const std::array<const QString, 2> editPaths = { ":/icons/worldedit.ico", ":/icons/worldedit_mod.ico" };
+    const size_t game = size_t(modEnabled<<1)|exp;
+
+    launchGameAc->setIcon(u::lazyIcon(gameIcons[game], gamePaths[game]));
     launchGameAc->setToolTip(d::LAUNCH_X.arg(modEnabled ? core->mountedMod+" ("+(exp ? d::EXPANSION : d::CLASSIC)+")"
                                                         : exp ? d::TFT : d::ROC));
-    launchEditorAc->setIcon(editIcons[modEnabled]);
+    launchEditorAc->setIcon(u::lazyIcon(editIcons[modEnabled], editPaths[modEnabled]));
     launchEditorAc->setToolTip(d::LAUNCH_X.arg(d::WE)+(modEnabled ? " ("+core->mountedMod+")"
                                                                   : QString()));
 
@@ -382,25 +530,7 @@ void MainWindow::updateMountState(const QString &modName, const bool enableBtn)
         connect(toggleMountBtn, &QPushButton::clicked, this, &MainWindow::mountMod);
         connect(toggleMountAc,  &QAction::triggered,   this, &MainWindow::mountMod);
 
-        if(!modName.isEmpty() && md::exists(modTable->modData, modName))
-        {
-            const int row = modTable->row(modName);
-
-            QWidget *nameItem  = modTable->cellWidget(row, 0),
-                    *sizeItem  = modTable->cellWidget(row, 1),
-                    *filesItem = modTable->cellWidget(row, 2);
-            if(nameItem->styleSheet() != QString())
-            {
-                nameItem->setStyleSheet(QString());
-                sizeItem->setStyleSheet(QString());
-                filesItem->setStyleSheet(QString());
-                nameItem->setFont(modTable->font());
-                sizeItem->setFont(modTable->font());
-                filesItem->setFont(modTable->font());
-
-                modTable->resizeCR(row);
-            }
-        }
+        modTable->mods->setMounted(QString());
     }
     else
     {
@@ -411,30 +541,12 @@ void MainWindow::updateMountState(const QString &modName, const bool enableBtn)
         connect(toggleMountBtn, &QPushButton::clicked, this, &MainWindow::unmountMod);
         connect(toggleMountAc,  &QAction::triggered,   this, &MainWindow::unmountMod);
 
-        if(md::exists(modTable->modData, modName.isEmpty() ? core->mountedMod : modName))
-        {
-            const int row = modTable->row(modName.isEmpty() ? core->mountedMod : modName);
-
-            QWidget *nameItem  = modTable->cellWidget(row, 0),
-                    *sizeItem  = modTable->cellWidget(row, 1),
-                    *filesItem = modTable->cellWidget(row, 2);
-
-            if(nameItem->styleSheet() == QString())
-            {
-                const QString &style = "border: 2px dashed #f7f500; background-color: #555; color: #eee;";
-
-                nameItem->setStyleSheet(style+"border-right: 0;");
-                sizeItem->setStyleSheet(style+"border-left: 0; border-right: 0;");
-                filesItem->setStyleSheet(style+"border-left: 0;");
-                nameItem->setFont(modTable->font());
-                sizeItem->setFont(modTable->font());
-                filesItem->setFont(modTable->font());
-                
-                modTable->resizeCR(row);
-            }
-        }
+        modTable->mods->setMounted(modName.isEmpty() ? core->mountedMod : modName);
     }
 
+    overlayMountAc->setEnabled(core->mountedMod.isEmpty());
+    layeredMountAc->setEnabled(core->mountedMod.isEmpty());
+
     if(!modName.isEmpty()) modTable->setFocus();
     updateLaunchBtns();
     if(enableBtn) toggleMountBtn->setEnabled(true);
@@ -458,107 +570,200 @@ void MainWindow::refresh(const bool silent)
     if(!silent) showMsg(d::REFRESHING___, Msgr::Busy);
 
     core->mountedMod = core->getMounted();
+    modWatcher->setPaths(core->cfg.pathMods, core->cfg.getSetting(Config::kGamePath));
     
     Thread *thr = new Thread(ThreadAction::ModData, QString(), core->cfg.pathMods);
     connect(thr, &Thread::modDataReady, this, &MainWindow::scanMods);
-    thr->start(modTable->modData, core->mountedMod);
+    thr->start(modTable->mods->registry, core->mountedMod);
 
     updateAllowOrVersion();
     updateAllowOrVersion(true);
 }
 
-void MainWindow::scanMods(const md::modData &modData, const QStringList &modNames)
+QString MainWindow::modPath(const QString &modName) const
 {
-    const QString &selectedMod = modTable->modSelected() && modTable->currentRow() < modTable->modNames.length()
-                                    ? modTable->modNames[modTable->currentRow()] : QString();
-    int selectedRow = -1;
-    bool mountedFound = core->mountedMod.isEmpty();
+    if(modName == core->mountedMod)
+    {
+        const QString &mountPath = core->cfg.getSetting(Config::kGamePath)+"/"+md::w3mod;
+        const QFileInfo &fiMounted(mountPath);
 
-    modTable->setRowCount(0);
-    modTable->modData = modData;
-    modTable->modNames = modNames;
-    scanCount = modTable->modNames.length();
+        if(fiMounted.absolutePath() != core->cfg.pathMods) // External mod: scan what war3mod.mpq points to
+        {
+            if(!fiMounted.exists()) return QString(); // a folder, or an archive sized from its tables
+            return fiMounted.isSymLink() ? fiMounted.symLinkTarget() : mountPath;
+        }
+    }
+    return core->cfg.pathMods+"/"+modName;
+}
 
-    for(const QString &modName : modTable->modNames)
+void MainWindow::scanMods(const md::Diff &diff)
+{
+    ModModel *const mods = modTable->mods;
+
+    // Patch the list: unchanged mods keep their row, size and file count
+    for(const QString &modName : diff.removed)
+    {
+        scanEngine->cancel(modName);
+        scanning.remove(modName);
+        scanEngine->conflicts().removeMod(modName);
+        ModStore::shared().dropMod(modName); // deleted outside the app: objects only it used can be swept
+        ModManifest::remove(modName);
+        mods->removeMod(modName);
+    }
+    // Rows stay in listing order whatever the refreshes before did; an external mod keeps row 0
+    for(const md::Diff::Entry &entry : diff.added)
+        if(entry.row == 0 && !mods->registry.contains(entry.name) && isExternal(entry.name))
+            mods->insertMod(entry.name, 0, false);
+    const int first = mods->rowCount() && isExternal(mods->registry.name(0)) ? 1 : 0;
+
+    for(const std::pair<QString, md::Diff::Entry> &renamed : diff.renamed)
     {
-        const int row = modTable->rowCount();
-        bool externalMod = false;
+        scanEngine->cancel(renamed.first);
+        scanning.remove(renamed.first);
+        scanEngine->moveIndex(core->cfg.pathMods+"/"+renamed.first, core->cfg.pathMods+"/"+renamed.second.name);
+        scanEngine->conflicts().renameMod(renamed.first, renamed.second.name);
+        ModStore::shared().renameMod(renamed.first, renamed.second.name);
+        ModManifest::rename(renamed.first, renamed.second.name); // Verify keeps comparing against its baseline
+        mods->renameMod(renamed.first, renamed.second.name);
+        mods->placeMod(renamed.second.name, first);
+        mods->registry.setStamp(renamed.second.name, renamed.second.stamp);
+    }
+    if(!diff.removed.isEmpty() || !diff.renamed.empty()) ModStore::shared().save();
 
-        modTable->addMod(modName, row);
+    for(const md::Diff::Entry &entry : diff.added)
+    {
+        if(mods->registry.contains(entry.name)) continue; // already added by an overlapping refresh, or external
+        mods->insertMod(entry.name, mods->registry.sortedRow(entry.name, first), false);
+        mods->registry.setStamp(entry.name, entry.stamp);
+    }
+    for(const md::Diff::Entry &entry : diff.changed)
+        mods->registry.setStamp(entry.name, entry.stamp);
 
-        if(modName == selectedMod) selectedRow = row;
+    if(!diff.removed.isEmpty() || !diff.renamed.empty() || !diff.added.empty()) modTable->resizeCR();
 
-        if(mountedFound || modName != core->mountedMod)
-        {
-            if(core->cfg.getSetting(Config::kHideEmpty) == Config::vOn) modTable->hideRow(row);
-        }
-        else
+    // Scan every mod: a file changed in a subfolder leaves the mod folder's mtime alone, and folders whose mtime
+    // is unchanged come from the index, so an unchanged mod costs a stat per folder. A mod still scanning is
+    // restarted, and counted once
+    for(int row=0; row < mods->registry.count(); ++row)
+    {
+        const QString &modName = mods->registry.name(row), &path = modPath(modName);
+        if(!path.isEmpty() && !mods->registry.isBusy(modName))
         {
-            mountedFound = true;
-
-            if(selectedRow == -1) selectedRow = row;
-            
-            const QString &modPath = core->cfg.getSetting(Config::kGamePath)+"/"+md::w3mod;
-            const QFileInfo &fiMounted(modPath);
-            
-            externalMod = fiMounted.absolutePath() != core->cfg.pathMods;
-            if(externalMod)
-            {
-                if(fiMounted.exists() && fiMounted.isDir())
-                {
-                    Thread *thr = new Thread(ThreadAction::ScanEx, modName);
-                    connect(thr, &Thread::scanModUpdate, modTable, &ModTable::updateMod);
-                    connect(thr, &Thread::scanModReady,  this,     &MainWindow::scanModDone);
-                    thr->start(fiMounted.isSymLink() ? fiMounted.symLinkTarget() : modPath);
-                }
-                else scanModDone(modName);
-            }
+            scanEngine->scan(modName, path, ThreadAction::IndexedScan);
+            scanning.insert(modName);
         }
+    }
 
-        if(!externalMod)
-        {
-            Thread *thr = new Thread(ThreadAction::Scan, modName, core->cfg.pathMods);
-            connect(thr, &Thread::scanModUpdate, modTable, &ModTable::updateMod);
-            connect(thr, &Thread::scanModReady,  this,     &MainWindow::scanModDone);
-            thr->start();
-        }
+    scanGame();
+
+    QStringList roots, modNames;
+    const QString &gamePath = core->cfg.getSetting(Config::kGamePath);
+    if(QFileInfo(gamePath).isDir()) roots << gamePath;
+
+    const md::Registry &registry = mods->registry;
+    const bool hideEmpty = core->cfg.getFlag<Config::kHideEmpty>();
+    for(int row=0; row < registry.count(); ++row)
+    {
+        const QString &modName = registry.name(row), &path = modPath(modName);
+        if(!path.isEmpty()) roots << path;
+        modNames << modName;
+
+        modTable->setRowHidden(row, hideEmpty && modName != core->mountedMod // Shown again by updateMod() once not empty
+                                              && registry.size(row) <= 0 && registry.fileCount(row) == 0);
     }
+    scanEngine->pruneIndex(roots); // forget mods that are gone
+    scanEngine->conflicts().retain(modNames);
+    modWatcher->watchMods(modNames);
 
-    if(selectedRow >= 0 && selectedRow < modTable->rowCount()) modTable->selectRow(selectedRow);
+    const int mountedRow = modTable->row(core->mountedMod);
+    if(!modTable->modSelected() && mountedRow >= 0) modTable->selectRow(mountedRow);
 
-    if(!core->mountedMod.isEmpty() && !mountedFound)
+    if(!core->mountedMod.isEmpty() && mountedRow < 0)
         showMsg(d::FAILED_TO_FIND_MOUNTED_X_.arg(core->mountedMod), Msgr::Critical);
 
     updateMountState();
-}
 
-void MainWindow::scanModDone(const QString &modName)
-{
-    if(md::exists(modTable->modData, modName))
+    if(!ready)
     {
-        const int row = modTable->row(modName);
+        ready = true;
+        Timeline::mark("listed");
+        showMsg(d::READY_, Msgr::Permanent);
+        core->closeSplash(this);
+    }
+
+    if(scanning.isEmpty()) refreshDone();
+}
 
-        if(row == modTable->currentRow())
-        modTable->setFocus();
+void MainWindow::rescanMod(const QString &modName)
+{   // watcher: some folder of the mod changed, but not which file, so walk it all
+    const QString &path = modPath(modName);
+    if(!path.isEmpty() && modTable->row(modName) >= 0 && !modTable->mods->registry.isBusy(modName))
+    {
+        scanEngine->scan(modName, path, ThreadAction::FullScan);
+        scanning.insert(modName);
     }
+}
+
+void MainWindow::scanGame()
+{   // the game folder's loose files, for the conflict index: not the mods folder, the farm or the mount in it
+    const QString &gamePath = core->cfg.getSetting(Config::kGamePath);
+    if(gamePath == gameScanned || !QFileInfo(gamePath).isDir()) return;
 
-    if(--scanCount <= 0)
+    QStringList skip(md::w3mod);
+    const QDir game(gamePath);
+    for(const QString &path : { core->cfg.pathMods, core->cfg.pathMods+"/"+LayerStack::DIR })
     {
-        refreshBtn->setEnabled(true);
-        if(refreshing)
+        const QString &rel = game.relativeFilePath(path); // absolute when on another drive
+        if(!rel.startsWith("..") && !QDir::isAbsolutePath(rel)) skip << rel;
+    }
+
+    scanEngine->scan(ConflictIndex::GAME, gamePath, ThreadAction::IndexedScan, skip);
+    scanning.insert(ConflictIndex::GAME);
+    gameScanned = gamePath;
+}
+
+void MainWindow::scanModDone(const QString &modName)
+{
+    const int row = modTable->row(modName);
+    if(row >= 0 && row == modTable->currentRow()) modTable->setFocus();
+
+    if(row >= 0 && !isExternal(modName)) // watch the subfolders this scan found
+        if(const std::shared_ptr<const ModIndex::Tree> tree = scanEngine->indexed(core->cfg.pathMods+"/"+modName))
         {
-            refreshing = false;
-            showMsg(d::REFRESHED_);
+            QStringList folders;
+            for(const std::pair<const QString, ModIndex::Dir> &dir : *tree) folders << dir.first;
+            modWatcher->watchFolders(modName, folders);
         }
+
+    scanning.remove(modName);
+    if(scanning.isEmpty()) refreshDone();
+}
+
+void MainWindow::refreshDone()
+{
+    refreshBtn->setEnabled(true);
+    Timeline::mark("scanned");
+    Timeline::save(); // the first time only
+
+    if(refreshing)
+    {
+        refreshing = false;
+        showMsg(d::REFRESHED_);
     }
 }
 
 void MainWindow::mountMod()
+{ mount(false); }
+
+void MainWindow::mountModOverlay()
+{ mount(true); }
+
+void MainWindow::mount(const bool overlay)
 {
     if(!modTable->modSelected()) showMsg(d::SELECT_MOD_TO_MOUNT_, Msgr::Info);
     else
     {
-        const QString &modName = modTable->modNames[modTable->currentRow()];
+        const QString &modName = modTable->selectedMod();
 
         if(tryBusy(modName) && core->mountModCheck(modName) == Core::MountReady)
         {
@@ -567,13 +772,73 @@ void MainWindow::mountMod()
             core->mountedMod = modName;
             Thread *thr = core->mountModThread(modName);
             connect(thr, &Thread::resultReady, this, &MainWindow::actionDone);
-            thr->start();
+            modWatcher->hold();
+            thr->start(overlay && QFileInfo(core->cfg.pathMods+"/"+modName).isDir()); // a packed mod is always linked whole
         }
 
         updateMountState(modName, false);
     }
 }
 
+void MainWindow::mountLayered()
+{
+    const QStringList &last = core->cfg.getSetting(Config::kLayers).split('/', QString::SkipEmptyParts);
+
+    QDialog layersDg(this);
+    layersDg.setWindowTitle(d::MOUNT_LAYERED);
+    QVBoxLayout *layersLayout = new QVBoxLayout;
+    layersDg.setLayout(layersLayout);
+        layersLayout->addWidget(new QLabel(d::LAYERS_HINT));
+        QListWidget *layersList = new QListWidget;
+        layersList->setDragDropMode(QAbstractItemView::InternalMove); // the order is the stacking order
+        layersLayout->addWidget(layersList);
+        QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
+        layersLayout->addWidget(buttonBox);
+
+    // top layer first, as the list reads; last stack first, the other folder mods below it
+    QStringList modNames;
+    for(const QString &modName : core->modNames())
+        if(QFileInfo(core->cfg.pathMods+"/"+modName).isDir() && !last.contains(modName)) modNames << modName;
+    for(const QString &modName : last)
+        if(QFileInfo(core->cfg.pathMods+"/"+modName).isDir()) modNames.prepend(modName);
+
+    for(const QString &modName : modNames)
+    {
+        QListWidgetItem *item = new QListWidgetItem(modName, layersList);
+        item->setFlags(item->flags()|Qt::ItemIsUserCheckable);
+        item->setCheckState(last.contains(modName) ? Qt::Checked : Qt::Unchecked);
+    }
+
+    connect(buttonBox, &QDialogButtonBox::accepted, &layersDg, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &layersDg, &QDialog::reject);
+    if(layersDg.exec() != QDialog::Accepted) return;
+
+    QStringList layers; // bottom first
+    for(int i=0; i < layersList->count(); ++i)
+        if(layersList->item(i)->checkState() == Qt::Checked) layers.prepend(layersList->item(i)->text());
+
+    if(layers.size() < 2) showMsg(d::SELECT_2_MODS_TO_LAYER_, Msgr::Info);
+    else
+    {
+        core->cfg.saveSetting(Config::kLayers, layers.join('/'));
+        core->cfg.saveConfig();
+
+        const QString &stackName = LayerStack::name(layers);
+        if(core->mountModCheck(stackName) == Core::MountReady)
+        {
+            toggleMountBtn->setEnabled(false);
+
+            core->mountedMod = stackName;
+            Thread *thr = core->mountModThread(stackName);
+            connect(thr, &Thread::resultReady, this, &MainWindow::actionDone);
+            modWatcher->hold();
+            thr->start(layers.join('/'));
+        }
+
+        updateMountState(stackName, false);
+    }
+}
+
 void MainWindow::unmountMod()
 {
     if(tryBusy(core->mountedMod) && core->unmountModCheck())
@@ -582,6 +847,7 @@ void MainWindow::unmountMod()
 
         Thread *thr = core->unmountModThread();
         connect(thr, &Thread::resultReady, this, &MainWindow::actionDone);
+        modWatcher->hold();
         thr->start();
     }
     else updateMountState(core->mountedMod);
@@ -618,6 +884,7 @@ void MainWindow::addMod()
                 connect(thr, &Thread::resultReady,   this,     &MainWindow::actionDone);
                 connect(thr, &Thread::modAdded, modTable, &ModTable::addMod);
                 connect(thr, &Thread::scanModUpdate, modTable, &ModTable::updateMod);
+                modWatcher->hold();
                 thr->start(src, dst, copyMove.clickedButton() == copyBtn);
             }
         }
@@ -629,30 +896,28 @@ void MainWindow::deleteMod()
     if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
     else
     {
-        const QString &modName = modTable->modNames[modTable->currentRow()];
+        const QString &modName = modTable->selectedMod();
 
         if(modName == core->mountedMod)
             showMsg(d::CANT_X_MOUNTED_.arg(d::lDELETE), Msgr::Info);
         else if(QMessageBox::warning(this, d::PERM_DELETE_Xq.arg(modName), d::PERM_DELETE_X_LONGq.arg(modName,
-                                         modTable->cellLabel(modTable->currentRow(), 1)->text(),
-                                         modTable->cellLabel(modTable->currentRow(), 2)->text()),
+                                         modTable->mods->text(modTable->currentRow(), ModModel::Size),
+                                         modTable->mods->text(modTable->currentRow(), ModModel::Files)),
                                      QMessageBox::Yes|QMessageBox::No) == QMessageBox::Yes
                 && tryBusy(modName))
         {
             showMsg(d::DELETING_X___.arg(modName), Msgr::Busy);
 
-            qint64 modSize = 0;
-            QString fileCount;
-            if(md::exists(modTable->modData, modName))
-            {
-                modSize = md::size(modTable->modData[modName]);
-                fileCount = modTable->cellLabel(modTable->row(modName), 2)->text();
-            }
+            const md::Registry &registry = modTable->mods->registry;
+            const int row = registry.row(modName);
+            const qint64 modSize = row >= 0 ? registry.size(row) : 0;
+            const int fileCount  = row >= 0 ? registry.fileCount(row) : 0;
 
             Thread *thr = new Thread(ThreadAction::Delete, modName, core->cfg.pathMods, core->cfg.getSetting(Config::kGamePath));
             connect(thr, &Thread::resultReady,   this,     &MainWindow::actionDone);
             connect(thr, &Thread::modDeleted,    modTable, &ModTable::deleteMod);
             connect(thr, &Thread::scanModUpdate, modTable, &ModTable::updateMod);
+            modWatcher->hold();
             thr->start(modSize, fileCount);
         }
     }
@@ -665,16 +930,23 @@ void MainWindow::actionDone(const ThreadAction &action)
         core->actionDone(action);
         updateMountState(action.modName);
 
-        if(action == ThreadAction::Unmount)
+        if(action == ThreadAction::Mount && action.success() && isExternal(action.modName))
+            QTimer::singleShot(0, this, [this]{ refresh(true); }); // a layered mount: list its stack once the watcher is released
+        else if(action == ThreadAction::Unmount)
         {
             const QFileInfo &fiMod(core->cfg.pathMods+"/"+action.modName);
 
             if(isExternal(action.modName)) modTable->deleteMod(action.modName);
         }
     }
+    else if(action == ThreadAction::Dedup && action.success())
+        showMsg(Core::a2s(action)+" "+d::X_SAVED_BY_LINKS_.arg(ThreadBase::getMB(ModStore::shared().savedBytes())));
     else showMsg(Core::a2s(action));
 
     modTable->setIdle(action.modName);
+    modWatcher->release(); // deliver what the action changed on disk
+
+    if(action == ThreadAction::Delete) reaper->reap();
 }
 
 void MainWindow::renameMod()
@@ -682,7 +954,7 @@ void MainWindow::renameMod()
     if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
     else
     {
-        const QString &modName = modTable->cellLabel(modTable->currentRow(), 0)->text();
+        const QString &modName = modTable->selectedMod();
 
         if(modName == core->mountedMod) showMsg(d::CANT_X_MOUNTED_.arg(d::lRENAME), Msgr::Info);
         else if(tryBusy(modName))
@@ -711,13 +983,18 @@ void MainWindow::renameMod()
 void MainWindow::renameModSave()
 {
     const QString &newName = renameEdit->text(),
-                  &modName = modTable->cellLabel(modTable->currentRow(), 0)->text();
+                  &modName = modTable->selectedMod();
 
     if(newName.isEmpty() || modName == newName) renameModDone();
-    else if(md::exists(modTable->modData, newName)) showMsg(d::MOD_EXISTS_, Msgr::Error);
+    else if(modTable->mods->registry.contains(newName)) showMsg(d::MOD_EXISTS_, Msgr::Error);
     else if(!u::isValidFileName(newName)) showMsg(d::INVALID_X.arg(d::lFILENAME)+".\n"+d::CHARACTERS_NOT_ALLOWED, Msgr::Error);
     else if(QFile::rename(core->cfg.pathMods+"/"+modName, core->cfg.pathMods+"/"+newName))
     {
+        scanEngine->moveIndex(core->cfg.pathMods+"/"+modName, core->cfg.pathMods+"/"+newName);
+        scanEngine->conflicts().renameMod(modName, newName);
+        ModStore::shared().renameMod(modName, newName);
+        ModStore::shared().save();
+        ModManifest::rename(modName, newName);
         modTable->renameMod(modName, newName);
         renameModDone();
     }
@@ -726,7 +1003,7 @@ void MainWindow::renameModSave()
 
 void MainWindow::renameModDone()
 {
-    modTable->setIdle(modTable->cellLabel(modTable->currentRow(), 0)->text());
+    modTable->setIdle(modTable->selectedMod());
     renameDg->close();
 }
 
@@ -750,7 +1027,7 @@ void MainWindow::openModFolder()
 {
     if(modTable->modSelected())
     {
-        const QString &modName = modTable->modNames[modTable->currentRow()];
+        const QString &modName = modTable->selectedMod();
 
         if(isExternal(modName)) openFolder(core->cfg.getSetting(Config::kGamePath)+"/"+md::w3mod, modName);
         else openFolder(core->cfg.pathMods+"/"+modName, modName);
@@ -764,6 +1041,141 @@ void MainWindow::openShortcuts()
     shortcuts.exec();
 }
 
+void MainWindow::cleanBackups()
+{
+    showMsg(d::CLEANING_UP_BACKUPS___, Msgr::Busy);
+
+    const qint64 maxAgeMs = core->cfg.getNumber<Config::kBackupMaxDays>()*24*60*60*1000,
+                 maxSize  = core->cfg.getNumber<Config::kBackupMaxMB>()*1024*1024;
+
+    // Deleting a backed up game folder can take a while: keep it off the GUI thread
+    std::shared_ptr<BackupManifest::Freed> freed = std::make_shared<BackupManifest::Freed>();
+    QThread *gc = QThread::create([=]{ *freed = BackupManifest::shared().gc(maxAgeMs, maxSize); });
+    connect(gc, &QThread::finished, this, [this, gc, freed]{
+        showMsg(d::X_BACKUPS_DELETED_X_.arg(freed->count).arg(freed->size ? ThreadBase::getMB(freed->size) : d::ZERO_MB));
+        gc->deleteLater();
+    });
+    gc->start();
+}
+
+void MainWindow::dedupMod()
+{
+    if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
+    else
+    {
+        const QString &modName = modTable->selectedMod();
+
+        if(isExternal(modName)) showMsg(d::NO_FILES_TO_X.arg(d::lDEDUPLICATE)+".", Msgr::Info);
+        else if(tryBusy(modName)) startOnMods(ThreadAction::Dedup, { modName }, modName);
+    }
+}
+
+void MainWindow::dedupAll()
+{
+    const QStringList &modNames = idleMods();
+
+    if(modNames.isEmpty()) showMsg(d::NO_FILES_TO_X.arg(d::lDEDUPLICATE)+".", Msgr::Info);
+    else startOnMods(ThreadAction::Dedup, modNames, d::lALL_MODS);
+}
+
+void MainWindow::verifyMod()
+{
+    if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
+    else
+    {
+        const QString &modName = modTable->selectedMod();
+
+        if(isExternal(modName)) showMsg(d::NO_FILES_TO_X.arg(d::lVERIFY)+".", Msgr::Info);
+        else if(tryBusy(modName)) startOnMods(ThreadAction::Verify, { modName }, modName);
+    }
+}
+
+void MainWindow::packMod()
+{
+    if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
+    else
+    {
+        const QString &modName = modTable->selectedMod();
+
+        if(isExternal(modName) || !QFileInfo(core->cfg.pathMods+"/"+modName).isDir())
+            showMsg(d::NO_FILES_TO_X.arg(d::lPACK)+".", Msgr::Info);
+        else if(modTable->mods->registry.contains(modName+".mpq")) showMsg(d::MOD_EXISTS_, Msgr::Error);
+        else if(tryBusy(modName)) startOnMods(ThreadAction::Pack, { modName }, modName);
+    }
+}
+
+void MainWindow::showConflicts()
+{
+    if(!modTable->modSelected()) showMsg(d::NO_MOD_X_.arg(d::lSELECTED));
+    else
+    {
+        const QString &modName = modTable->selectedMod();
+        const bool overlaid = Overlay::mountedMod() == modName; // its files are in the game folder on purpose
+
+        QStringList lines;
+        for(ConflictIndex::Conflict &conflict : scanEngine->conflicts().conflicts(modName))
+        {
+            if(overlaid) conflict.modNames.removeAll(ConflictIndex::GAME);
+            if(conflict.modNames.isEmpty()) continue;
+
+            conflict.modNames.replaceInStrings(ConflictIndex::GAME, d::X_FOLDER.arg(d::GAME));
+            lines << d::X_ALSO_IN_X.arg(conflict.path, conflict.modNames.join(", "));
+        }
+
+        if(lines.isEmpty()) showMsg(d::NO_CONFLICTS_X_.arg(modName), Msgr::Info);
+        else
+        {
+            QMessageBox conflicts(QMessageBox::Information, d::CONFLICTS+" - "+modName,
+                                  d::X_CONFLICTS_X_.arg(lines.size()).arg(modName), QMessageBox::Ok, this);
+            conflicts.setDetailedText(lines.join('\n'));
+            conflicts.exec();
+        }
+    }
+}
+
+void MainWindow::verifyAll()
+{
+    const QStringList &modNames = idleMods();
+
+    if(modNames.isEmpty()) showMsg(d::NO_FILES_TO_X.arg(d::lVERIFY)+".", Msgr::Info);
+    else startOnMods(ThreadAction::Verify, modNames, d::lALL_MODS);
+}
+
+QStringList MainWindow::idleMods() const
+{
+    QStringList modNames;
+    const md::Registry &registry = modTable->mods->registry;
+    for(int row=0; row < registry.count(); ++row)
+    {
+        const QString &modName = registry.name(row);
+        if(!registry.isBusy(modName) && modName != md::unknownMod
+           && QFileInfo(core->cfg.pathMods+"/"+modName).isDir()) modNames << modName; // busy ones are left for next time
+    }
+    return modNames;
+}
+
+void MainWindow::startOnMods(const ThreadAction::Action thrAction, const QStringList &modNames, const QString &label,
+                             const bool accept)
+{
+    for(const QString &modName : modNames) modTable->mods->setBusy(modName, true);
+
+    Thread *thr = new Thread(thrAction, label, core->cfg.pathMods);
+    showMsg(d::X_X.arg(ThreadAction(thrAction).PROCESSING, label)+"...", Msgr::Busy);
+
+    connect(thr, &Thread::resultReady, this, &MainWindow::actionDone);
+    connect(thr, &Thread::resultReady, this, [this, modNames, label, accept](const ThreadAction &action) {
+        for(const QString &modName : modNames) modTable->setIdle(modName);
+
+        // Verify keeps reporting changes against the first run until they are accepted
+        if(action == ThreadAction::Verify && !accept && !action.aborted()
+           && (action.get(ThreadAction::Failed) || action.get(ThreadAction::Missing))
+           && QMessageBox::question(this, d::VERIFY, d::ACCEPT_CHANGES_Xq.arg(label)) == QMessageBox::Yes)
+            startOnMods(ThreadAction::Verify, modNames, label, true);
+    });
+    modWatcher->hold();
+    thr->start(modNames.join('/'), accept);
+}
+
 void MainWindow::openSettings()
 {
     Settings settings(this, core->cfg, &msgr);
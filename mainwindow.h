@@ -3,53 +3,97 @@
 
 #include "_msgr.h"
 #include "_moddata.h"
+#include "threadbase.h"
 #include <QMainWindow>
-#include <QTableWidget>
+#include <QTableView>
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include <QSet>
 #include <set>
 #include <tuple>
 
 class Core;
-class ThreadAction;
+class ScanEngine;
+class ModWatcher;
+class Reaper;
 class QCheckBox;
 class QPushButton;
 class QLabel;
-class QTableWidgetItem;
 
 #include <QDebug>
 
-class ModTable : public QTableWidget
+/* md::Registry is the storage of the mod list; rows cost no widgets
+ * and size/file count updates are plain dataChanged() ranges */
+class ModModel : public QAbstractTableModel
 {
     Q_OBJECT
 
-public:        md::modData modData;
-               QStringList modNames;
+public:        enum Column { Name, Size, Files, Column_Size };
+               enum Role   { MountedRole = Qt::UserRole };
+
+               md::Registry registry;
+private:       QString      mountedMod;
+
+public:        explicit ModModel(QObject *parent=nullptr) : QAbstractTableModel(parent) {}
+
+               int      rowCount   (const QModelIndex &parent=QModelIndex()) const override
+               { return parent.isValid() ? 0 : registry.count(); }
+               int      columnCount(const QModelIndex &parent=QModelIndex()) const override
+               { return parent.isValid() ? 0 : Column_Size; }
+               QVariant data      (const QModelIndex &index, int role=Qt::DisplayRole) const override;
+               QVariant headerData(int section, Qt::Orientation orientation, int role=Qt::DisplayRole) const override;
+
+               int     row (const QString &modName) const { return registry.row(modName); }
+               QString text(const int row, const Column column) const
+               { return data(index(row, column)).toString(); }
+
+               void setBusy(const QString &modName, const bool busy) { registry.setBusy(modName, busy); }
+
+               void insertMod(const QString &modName, const int row, const bool busy=true);
+               void placeMod (const QString &modName, const int first); // to its sorted row, below row `first`
+               void removeMod(const QString &modName);
+               void renameMod(const QString &modName, const QString &newName);
+               void updateMod(const QString &modName, const qint64 size, const int fileCount, const int links=0);
+               void setMounted(const QString &modName);
+};
+
+class ModDelegate : public QStyledItemDelegate
+{
+public:        explicit ModDelegate(QObject *parent=nullptr) : QStyledItemDelegate(parent) {}
+
+               void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+class ModTable : public QTableView
+{
+    Q_OBJECT
+
+public:        ModModel *const mods;
 
                ModTable();
 
-               QLabel* cellLabel(const int row, const int column) const;
+               int  currentRow()  const { return currentIndex().row(); }
+               bool modSelected() const { return currentRow() >= 0 && currentRow() < mods->rowCount(); }
+               QString selectedMod() const { return modSelected() ? mods->registry.name(currentRow()) : QString(); }
 
-               bool modSelected() const { return currentRow() >= 0 && currentRow() < rowCount(); }
+               int  row(const QString &modName) const { return mods->row(modName); }
+               void setIdle(const QString &modName) { mods->setBusy(modName, false); }
 
-               int row(const QString &modName) const
-               { return md::exists(modData, modName) ? std::get<int(md::Row)>(modData.at(modName)) : -1; }
-               void setSize(const QString &modName, const qint64 size)
-               { std::get<int(md::Size)>(modData[modName]) = size; }
-               void setIdle(const QString &modName)
-               { if(md::exists(modData, modName)) std::get<int(md::Busy)>(modData[modName]) = false; }
+private:       void fitColumn(const int row, const ModModel::Column column);
 
-public slots:  void updateMod(const QString &modName, const QString &modSize, const QString &fileCount, const qint64 size);
-               void addMod   (const QString &modName, const int row, const bool addData=false);
+public slots:  void updateMod(const QString &modName, const qint64 size, const int fileCount, const int links=0);
+               void addMod   (const QString &modName, const int row);
                void deleteMod(const QString &modName);
                void renameMod(const QString &modName, const QString &newName);
 
-               void resizeCR(const int row=-1);
+               void resizeCR();
 };
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
-               QAction      *launchGameAc, *launchEditorAc, *toggleMountAc;
+               QAction      *launchGameAc, *launchEditorAc, *toggleMountAc, *overlayMountAc, *layeredMountAc;
                QCheckBox    *allowFilesCbx, *gameVersionCbx;
                QPushButton  *toggleMountBtn, *addModBtn, *refreshBtn;
                QDialog      *renameDg;
@@ -59,12 +103,17 @@ class MainWindow : public QMainWindow
                Core *const core;
                Msgr msgr;
                ModTable *modTable;
+               ScanEngine *scanEngine;
+               ModWatcher *modWatcher;
+               Reaper     *reaper;
 
-               const std::array<const QIcon, 4> gameIcons;
-               const std::array<const QIcon, 2> editIcons;
+               std::array<QIcon, 4> gameIcons; // see updateLaunchBtns()
+               std::array<QIcon, 2> editIcons;
 
-               int  scanCount=0;
-               bool refreshing=false;
+               QSet<QString> scanning; // mods with a scan in flight, kept in step with ScanEngine::scan/cancel
+               QString gameScanned;    // the game folder as last scanned; cleared when the watcher sees it change
+               bool refreshing=false,
+                    ready=false; // the first listing is in
 
 public:        explicit MainWindow(Core *const core);
                void show();
@@ -83,12 +132,21 @@ private slots: void launchEditor();
                void setVersion(const bool enable){ setAllowOrVersion(true, enable); }
 
                void refresh(const bool silent=false);
-               void scanMods(const md::modData &modData, const QStringList &modNames);
+               void scanMods(const md::Diff &diff);
+               void rescanMod  (const QString &modName);
+               void scanGame();
                void scanModDone(const QString &modName);
-
-               void mountMod();
+private:       void refreshDone();
+               QString modPath(const QString &modName) const;
+private slots: void mountMod();
+               void mountModOverlay();
+               void mountLayered();
                void unmountMod();
-               void addMod();
+private:       void mount(const bool overlay);
+               void startOnMods(const ThreadAction::Action thrAction, const QStringList &modNames, const QString &label,
+                                const bool accept=false); // Dedup, Verify, Pack
+               QStringList idleMods() const;
+private slots: void addMod();
                void deleteMod();
                void actionDone(const ThreadAction &action);
 
@@ -102,6 +160,13 @@ private slots: void launchEditor();
                void openModFolder();
 
                void openShortcuts();
+               void cleanBackups();
+               void dedupMod();
+               void dedupAll();
+               void packMod();
+               void showConflicts();
+               void verifyMod();
+               void verifyAll();
                void openSettings();
                void openAbout();
 };
@@ -0,0 +1,128 @@
+#include "modindex.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QSet>
+
+const quint32 ModIndex::MAGIC   = 0x574d4d49, // "WMMI"
+              ModIndex::VERSION = 3; // 2: file names, 3: links
+
+ModIndex::ModIndex(const QString &path) : path(path)
+{ load(); }
+
+std::shared_ptr<const ModIndex::Tree> ModIndex::tree(const QString &root) const
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = trees.find(root);
+    return it == trees.end() ? nullptr : it->second;
+}
+
+void ModIndex::store(const QString &root, Tree &&tree)
+{
+    std::shared_ptr<const Tree> newTree = std::make_shared<const Tree>(std::move(tree));
+
+    QMutexLocker lock(&mutex);
+    trees[root] = std::move(newTree);
+    dirty = true;
+}
+
+void ModIndex::move(const QString &root, const QString &newRoot)
+{ // folder renamed: relative paths inside it are unchanged
+    QMutexLocker lock(&mutex);
+
+    const auto it = trees.find(root);
+    if(it != trees.end())
+    {
+        std::shared_ptr<const Tree> tree = std::move(it->second);
+        trees.erase(it);
+        trees[newRoot] = std::move(tree);
+        dirty = true;
+    }
+}
+
+void ModIndex::retain(const QStringList &roots)
+{
+    const QSet<QString> keep = QSet<QString>::fromList(roots);
+
+    QMutexLocker lock(&mutex);
+    for(auto it = trees.begin(); it != trees.end(); )
+    {
+        if(keep.contains(it->first)) ++it;
+        else
+        {
+            it = trees.erase(it);
+            dirty = true;
+        }
+    }
+}
+
+void ModIndex::load()
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    quint32 magic, version, treeCount;
+    in >> magic >> version >> treeCount;
+    if(magic != MAGIC || version != VERSION) return;
+
+    std::unordered_map<QString, std::shared_ptr<const Tree> > loaded;
+    for(quint32 i=0; i < treeCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString root;
+        quint32 dirCount;
+        in >> root >> dirCount;
+
+        Tree tree;
+        for(quint32 j=0; j < dirCount && in.status() == QDataStream::Ok; ++j)
+        {
+            QString rel;
+            Dir dir;
+            in >> rel >> dir.mtime >> dir.size >> dir.files >> dir.links >> dir.subdirs >> dir.fileNames;
+            tree.insert({ rel, std::move(dir) });
+        }
+
+        loaded.insert({ root, std::make_shared<const Tree>(std::move(tree)) });
+    }
+
+    if(in.status() == QDataStream::Ok) // a truncated index is dropped; the next scan rebuilds it
+    {
+        QMutexLocker lock(&mutex);
+        trees = std::move(loaded);
+        dirty = false;
+    }
+}
+
+bool ModIndex::save()
+{
+    std::unordered_map<QString, std::shared_ptr<const Tree> > snapshot;
+    {
+        QMutexLocker lock(&mutex);
+        if(!dirty) return true;
+        snapshot = trees;
+        dirty = false;
+    }
+
+    QSaveFile file(path);
+    if(file.open(QIODevice::WriteOnly))
+    {
+        QDataStream out(&file);
+        out << MAGIC << VERSION << quint32(snapshot.size());
+
+        for(const std::pair<const QString, std::shared_ptr<const Tree> > &tree : snapshot)
+        {
+            out << tree.first << quint32(tree.second->size());
+            for(const std::pair<const QString, Dir> &dir : *tree.second)
+                out << dir.first << dir.second.mtime << dir.second.size << dir.second.files << dir.second.links
+                    << dir.second.subdirs << dir.second.fileNames;
+        }
+
+        if(file.commit()) return true;
+    }
+
+    QMutexLocker lock(&mutex);
+    dirty = true;
+    return false;
+}
@@ -0,0 +1,43 @@
+#ifndef MODINDEX_H
+#define MODINDEX_H
+
+#include "_uo_map_qs.h"
+#include <QStringList>
+#include <QMutex>
+#include <memory>
+
+/* Persistent per-folder size/file count/file name cache, stored next to config.cfg.
+ * A folder's entry is only reused while its mtime is unchanged (adding, deleting or renaming
+ * an entry updates the mtime of the containing folder), so a scan only re-walks changed folders. */
+class ModIndex
+{
+public:  struct Dir {
+             qint64      mtime = 0,
+                         size  = 0;  // files directly in this folder
+             int         files = 0,
+                         links = 0;  // of them, sized by following a link
+             QStringList subdirs,
+                         fileNames; // for the conflict index
+         };
+         typedef std::unordered_map<QString, Dir> Tree; // key: path relative to the mod folder ("" for root)
+
+private: static const quint32 MAGIC, VERSION;
+
+         const QString path;
+
+         mutable QMutex mutex;
+         std::unordered_map<QString, std::shared_ptr<const Tree> > trees; // key: absolute mod path
+         bool dirty = false;
+
+public:  explicit ModIndex(const QString &path);
+
+         std::shared_ptr<const Tree> tree(const QString &root) const;
+         void store (const QString &root, Tree &&tree);
+         void move  (const QString &root, const QString &newRoot);
+         void retain(const QStringList &roots);
+
+         void load();
+         bool save();
+};
+
+#endif // MODINDEX_H
@@ -0,0 +1,82 @@
+#include "modmanifest.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QTextStream>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+const quint32 ModManifest::MAGIC   = 0x574d4d56, // "WMMV"
+              ModManifest::VERSION = 1;
+
+QString ModManifest::sharedDir;
+
+QString ModManifest::path(const QString &modName)
+{
+    return (sharedDir.isEmpty() ? QCoreApplication::applicationDirPath()+"/manifests" : sharedDir)+"/"+modName+".wmmv";
+}
+
+bool ModManifest::rename(const QString &modName, const QString &newName)
+{
+    return !QFile::exists(path(modName)) || QFile::rename(path(modName), path(newName));
+}
+
+bool ModManifest::remove(const QString &modName)
+{
+    return !QFile::exists(path(modName)) || QFile::remove(path(modName));
+}
+
+void ModManifest::log(const QString &modName, const QStringList &lines)
+{
+    QFile file(QFileInfo(path(modName)).absolutePath()+"/verify.log");
+    if(lines.isEmpty() || !file.open(QIODevice::WriteOnly|QIODevice::Append|QIODevice::Text)) return;
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    const QString &time = QDateTime::currentDateTime().toString(Qt::ISODate);
+    for(const QString &line : lines) out << time << " " << modName << ": " << line << "\n";
+}
+
+bool ModManifest::load(const QString &modName)
+{
+    QFile file(path(modName));
+    if(!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if(magic != MAGIC || version != VERSION) return false;
+
+    std::unordered_map<QString, Entry> loaded;
+    loaded.reserve(count);
+    for(quint32 i=0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString rel;
+        Entry entry;
+        in >> rel >> entry.size >> entry.mtime >> entry.hash;
+        loaded.insert({ rel, entry });
+    }
+
+    if(in.status() != QDataStream::Ok) return false; // truncated: the next Verify takes a new baseline
+    files = std::move(loaded);
+    return true;
+}
+
+bool ModManifest::save(const QString &modName) const
+{
+    const QString &path = ModManifest::path(modName);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out << MAGIC << VERSION << quint32(files.size());
+    for(const std::pair<const QString, Entry> &entry : files)
+        out << entry.first << entry.second.size << entry.second.mtime << entry.second.hash;
+
+    return file.commit();
+}
@@ -0,0 +1,33 @@
+#ifndef MODMANIFEST_H
+#define MODMANIFEST_H
+
+#include "_uo_map_qs.h"
+#include <QStringList>
+
+/* What Verify found in a mod the first time: size, mtime and XXH64 of every file, one binary file per mod
+ * in the manifests folder (<mod>.wmmv), outside the mod so mounting never sees it.
+ * It is the baseline later runs compare with: changes are reported until they are accepted. */
+class ModManifest
+{
+public:  struct Entry {
+             qint64  size  = 0,
+                     mtime = 0; // ms since epoch
+             quint64 hash  = 0;
+         };
+
+private: static const quint32 MAGIC, VERSION;
+         static QString sharedDir;
+
+public:  std::unordered_map<QString, Entry> files; // relative to the mod folder
+
+         static void    setPath(const QString &dir) { sharedDir = dir; }
+         static QString path(const QString &modName);
+         static bool    rename(const QString &modName, const QString &newName);
+         static bool    remove(const QString &modName);
+         static void    log(const QString &modName, const QStringList &lines); // appended to verify.log
+
+         bool load(const QString &modName); // false: none yet, or unreadable
+         bool save(const QString &modName) const;
+};
+
+#endif // MODMANIFEST_H
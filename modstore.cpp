@@ -0,0 +1,265 @@
+#define WINVER _WIN32_WINNT_WIN7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "modstore.h"
+#include "threadbase.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <algorithm>
+
+#include <windef.h>  // winbase.h needs to be
+#include <winbase.h> // preceded by windef.h
+
+const QString ModStore::DIR = QStringLiteral(u".store");
+
+const quint32 ModStore::MAGIC   = 0x574d4d53, // "WMMS"
+              ModStore::VERSION = 1;
+
+QString    ModStore::sharedPathMods;
+QAtomicInt ModStore::onAdd = 0;
+
+namespace {
+std::wstring native(const QString &path)
+{ return QDir::toNativeSeparators(path).toStdWString(); }
+}
+
+ModStore::ModStore(const QString &pathMods) : root(pathMods+"/"+DIR)
+{ load(); }
+
+ModStore &ModStore::shared()
+{
+    static ModStore store(sharedPathMods.isEmpty() ? QCoreApplication::applicationDirPath()+"/mods" : sharedPathMods);
+    return store;
+}
+
+QString ModStore::hash(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    return hash.addData(&file) ? QString::fromLatin1(hash.result().toHex()) : QString();
+}
+
+ModStore::Result ModStore::dedup(const QString &path, const qint64 size, QString &hash)
+{
+    if(size < MIN_SIZE) return Skipped;
+
+    hash = ModStore::hash(path);
+    if(hash.isEmpty()) return Failed;
+
+    const QString &object = objectPath(hash);
+    const QFileInfo fiObject(object);
+
+    if(fiObject.exists() && ThreadBase::fileId(object) == ThreadBase::fileId(path)) return Already;
+
+    // An object edited in place through one of its links no longer holds what its name says, size or not:
+    // the links that have it keep it as their own file, and this file takes the name over
+    if(fiObject.exists() && (fiObject.size() != size || ModStore::hash(object) != hash)
+       && !QFile::remove(object)) return Failed;
+
+    if(!QFileInfo::exists(object)) // first of its kind: the file itself becomes the object
+    {
+        QDir().mkpath(fiObject.absolutePath());
+        return CreateHardLink(native(object).c_str(), native(path).c_str(), nullptr) ? Stored : Failed;
+    }
+
+    // Link next to the file, then swap it in with one rename, so the file is never missing
+    const QString &tmp = path+".wmmdedup";
+    if(!CreateHardLink(native(tmp).c_str(), native(object).c_str(), nullptr)) return Failed;
+    if(MoveFileEx(native(tmp).c_str(), native(path).c_str(), MOVEFILE_REPLACE_EXISTING)) return Linked;
+
+    DeleteFile(native(tmp).c_str());
+    return Failed;
+}
+
+void ModStore::commit(const QString &modName, Pass &&pass)
+{
+    QMutexLocker lock(&mutex);
+
+    for(const std::pair<const QString, Ref> &object : pass.objects) ++refs[object.first];
+
+    const auto it = mods.find(modName);
+    if(it != mods.end()) unref(it->second);
+
+    if(pass.objects.empty()) mods.erase(modName);
+    else mods[modName] = std::move(pass.objects);
+    dirty = true;
+}
+
+void ModStore::dropMod(const QString &modName)
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = mods.find(modName);
+    if(it != mods.end())
+    {
+        unref(it->second);
+        mods.erase(it);
+        dirty = true;
+    }
+}
+
+void ModStore::renameMod(const QString &modName, const QString &newName)
+{
+    QMutexLocker lock(&mutex);
+
+    auto it = mods.find(modName);
+    if(it != mods.end() && mods.find(newName) == mods.end())
+    {
+        auto node = mods.extract(it);
+        node.key() = newName;
+        mods.insert(std::move(node));
+        dirty = true;
+    }
+}
+
+void ModStore::unref(const Objects &objects)
+{
+    for(const std::pair<const QString, Ref> &object : objects)
+    {
+        const auto it = refs.find(object.first);
+        if(it != refs.end() && --it->second <= 0)
+        {
+            refs.erase(it);
+            QFile::remove(objectPath(object.first)); // the mods' own links keep whatever still uses it
+        }
+    }
+}
+
+qint64 ModStore::uniqueBytes(const QString &modName, const qint64 apparent) const
+{
+    QMutexLocker lock(&mutex);
+
+    const auto it = mods.find(modName);
+    if(it == mods.end()) return apparent;
+
+    qint64 shared = 0;
+    for(const std::pair<const QString, Ref> &object : it->second)
+    {
+        const auto itRefs = refs.find(object.first);
+        const bool onlyHere = itRefs == refs.end() || itRefs->second <= 1;
+        shared += object.second.size*(object.second.count - onlyHere); // one copy is this mod's own
+    }
+
+    return std::max(apparent-shared, qint64(0));
+}
+
+qint64 ModStore::savedBytes() const
+{
+    QMutexLocker lock(&mutex);
+
+    std::unordered_map<QString, std::pair<qint64, int>> copies; // object -> size, files linked to it
+    for(const std::pair<const QString, Objects> &mod : mods)
+        for(const std::pair<const QString, Ref> &object : mod.second)
+        {
+            std::pair<qint64, int> &copy = copies[object.first];
+            copy.first = object.second.size;
+            copy.second += object.second.count;
+        }
+
+    qint64 saved = 0;
+    for(const std::pair<const QString, std::pair<qint64, int>> &copy : copies)
+        saved += copy.second.first*(copy.second.second-1);
+    return saved;
+}
+
+int ModStore::sweep()
+{
+    int removed = 0;
+    for(QDirIterator it(root, QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories); it.hasNext(); )
+    {
+        it.next();
+        if(it.fileName().startsWith("store.idx")) continue; // the index and QSaveFile's temporary copy
+
+        bool referenced;
+        {
+            QMutexLocker lock(&mutex);
+            referenced = refs.find(it.fileName()) != refs.end();
+        }
+        if(!referenced && QFile::remove(it.filePath())) ++removed;
+    }
+    return removed;
+}
+
+void ModStore::load()
+{
+    QFile file(root+"/store.idx");
+    if(!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    quint32 magic, version, modCount;
+    in >> magic >> version >> modCount;
+    if(magic != MAGIC || version != VERSION) return;
+
+    std::unordered_map<QString, Objects> loaded;
+    std::unordered_map<QString, int>     loadedRefs;
+    for(quint32 i=0; i < modCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString modName;
+        quint32 objectCount;
+        in >> modName >> objectCount;
+
+        Objects &objects = loaded[modName];
+        for(quint32 j=0; j < objectCount && in.status() == QDataStream::Ok; ++j)
+        {
+            QByteArray digest;
+            Ref ref;
+            in >> digest >> ref.size >> ref.count;
+
+            const QString &hash = QString::fromLatin1(digest.toHex());
+            objects.insert({ hash, ref });
+            ++loadedRefs[hash];
+        }
+    }
+
+    if(in.status() == QDataStream::Ok) // a truncated index is dropped; the next dedup of each mod rebuilds it
+    {
+        QMutexLocker lock(&mutex);
+        mods = std::move(loaded);
+        refs = std::move(loadedRefs);
+        dirty = false;
+    }
+}
+
+bool ModStore::save()
+{
+    std::unordered_map<QString, Objects> snapshot;
+    {
+        QMutexLocker lock(&mutex);
+        if(!dirty) return true;
+        snapshot = mods;
+        dirty = false;
+    }
+
+    QDir().mkpath(root);
+    QSaveFile file(root+"/store.idx");
+    if(file.open(QIODevice::WriteOnly))
+    {
+        QDataStream out(&file);
+        out << MAGIC << VERSION << quint32(snapshot.size());
+
+        for(const std::pair<const QString, Objects> &mod : snapshot)
+        {
+            out << mod.first << quint32(mod.second.size());
+            for(const std::pair<const QString, Ref> &object : mod.second)
+                out << QByteArray::fromHex(object.first.toLatin1()) << object.second.size << object.second.count;
+        }
+
+        if(file.commit()) return true;
+    }
+
+    QMutexLocker lock(&mutex);
+    dirty = true;
+    return false;
+}
@@ -0,0 +1,70 @@
+#ifndef MODSTORE_H
+#define MODSTORE_H
+
+#include "_uo_map_qs.h"
+#include <QMutex>
+#include <QAtomicInt>
+
+/* Content-addressed store for the mods folder: identical files of different mods become hardlinks to one object,
+ * mods/.store/<first 2 hex digits>/<sha-256>, so a fork of a mod only costs the files it changed.
+ * store.idx records the objects each mod references, which is all it takes to tell a mod's unique bytes
+ * (what deleting it would free) from its apparent size.
+ * Linked files share their contents: a tool that rewrites a file in place changes it for every mod that has it
+ * (saving to a new file, as most editors do, just breaks the link). */
+class ModStore
+{
+public:  enum Result { Stored, Linked, Already, Skipped, Failed };
+         static const QString DIR;
+         static const qint64  MIN_SIZE = 4096; // smaller files share a cluster's worth of nothing
+
+private: struct Ref {
+             qint64 size  = 0;
+             int    count = 0; // files of the mod with this content
+         };
+         typedef std::unordered_map<QString, Ref> Objects; // sha-256 (hex) -> ref
+
+         static const quint32 MAGIC, VERSION;
+         static QString    sharedPathMods;
+         static QAtomicInt onAdd;
+
+         const QString  root;
+         mutable QMutex mutex;
+         std::unordered_map<QString, Objects> mods;
+         std::unordered_map<QString, int>     refs; // object -> mods referencing it
+         bool dirty = false;
+
+         QString objectPath(const QString &hash) const { return root+"/"+hash.left(2)+"/"+hash; }
+         void    unref(const Objects &objects); // deletes objects no mod references any more; mutex held
+         void    load();
+
+public:  explicit ModStore(const QString &pathMods);
+         ~ModStore() { save(); }
+
+         static void setPath(const QString &pathMods) { sharedPathMods = pathMods; } // before the first shared()
+         static ModStore &shared();
+
+         static void setDedupOnAdd(const bool on) { onAdd.storeRelease(on); }
+         static bool dedupOnAdd() { return onAdd.loadAcquire(); }
+
+         static QString hash(const QString &path);
+
+         // Links `path` to the object with its contents (which it becomes if there is none yet); hash is set unless Skipped
+         Result dedup(const QString &path, const qint64 size, QString &hash);
+
+         class Pass { // objects met while deduplicating one mod; commit() replaces what the store knew of it
+             friend class ModStore;
+             Objects objects;
+         public:
+             void add(const QString &hash, const qint64 size) { Ref &ref = objects[hash]; ref.size = size; ++ref.count; }
+         };
+         void commit   (const QString &modName, Pass &&pass);
+         void dropMod  (const QString &modName);
+         void renameMod(const QString &modName, const QString &newName);
+
+         qint64 uniqueBytes(const QString &modName, const qint64 apparent) const;
+         qint64 savedBytes() const; // all mods: what the copies linked to an object would take on their own
+         int    sweep(); // objects no mod references (left by a crash or a mod edited since): deleted
+         bool   save();
+};
+
+#endif // MODSTORE_H
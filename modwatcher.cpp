@@ -0,0 +1,110 @@
+#include "modwatcher.h"
+
+#include <QFileInfo>
+
+const int ModWatcher::DEBOUNCE_MS = 500,
+          ModWatcher::MAX_FOLDERS = 128;
+
+/********************************************************************/
+/*      MOD WATCHER     *********************************************/
+/********************************************************************/
+    ModWatcher::ModWatcher(QObject *parent) : QObject(parent)
+    {
+        debounce.setSingleShot(true);
+        debounce.setInterval(DEBOUNCE_MS);
+
+        connect(&watcher,  &QFileSystemWatcher::directoryChanged, this, &ModWatcher::directoryChanged);
+        connect(&debounce, &QTimer::timeout,                      this, &ModWatcher::flush);
+    }
+
+    void ModWatcher::setPaths(const QString &pathMods, const QString &pathGame)
+    {
+        if(pathMods == this->pathMods && pathGame == this->pathGame) return;
+
+        const QStringList &watched = watcher.directories();
+        if(!watched.isEmpty()) watcher.removePaths(watched);
+
+        this->pathMods = pathMods;
+        this->pathGame = pathGame;
+        changedMods.clear();
+
+        QStringList paths;
+        for(const QString &path : { pathMods, pathGame })
+            if(!path.isEmpty() && QFileInfo(path).isDir()) paths << path;
+        if(!paths.isEmpty()) watcher.addPaths(paths);
+    }
+
+    void ModWatcher::watchMods(const QStringList &modNames)
+    {
+        QSet<QString> wanted;
+        for(const QString &modName : modNames) wanted.insert(pathMods+"/"+modName);
+        const QSet<QString> names = QSet<QString>::fromList(modNames);
+
+        QStringList remove;
+        for(const QString &path : watcher.directories())
+        {
+            if(path == pathMods || path == pathGame) continue;
+            if(!wanted.remove(path) && !names.contains(modOf(path))) remove << path; // subfolders of kept mods stay
+        }
+        if(!remove.isEmpty()) watcher.removePaths(remove);
+
+        QStringList add;
+        for(const QString &path : wanted)
+            if(QFileInfo(path).isDir()) add << path;
+        if(!add.isEmpty()) watcher.addPaths(add);
+    }
+
+    void ModWatcher::watchFolders(const QString &modName, const QStringList &folders)
+    {
+        const QString &root = pathMods+"/"+modName;
+
+        QSet<QString> wanted;
+        for(const QString &folder : folders)
+        {
+            if(wanted.size() == MAX_FOLDERS) break;
+            if(!folder.isEmpty()) wanted.insert(root+"/"+folder);
+        }
+
+        QStringList remove;
+        for(const QString &path : watcher.directories())
+            if(path.startsWith(root+"/") && !wanted.remove(path)) remove << path;
+        if(!remove.isEmpty()) watcher.removePaths(remove);
+
+        QStringList add;
+        for(const QString &path : wanted)
+            if(QFileInfo(path).isDir()) add << path;
+        if(!add.isEmpty()) watcher.addPaths(add);
+    }
+
+    void ModWatcher::release()
+    {
+        if(holds > 0 && --holds == 0 && pending()) debounce.start();
+    }
+
+    void ModWatcher::directoryChanged(const QString &path)
+    {
+        if(path == pathMods) listChanged = true;
+        else if(path == pathGame) gameChanged = true;
+        else if(path.startsWith(pathMods+"/"))
+        {
+            const QString &modName = modOf(path);
+            if(QFileInfo(pathMods+"/"+modName).isDir()) changedMods.insert(modName); // a subfolder may be gone
+            else listChanged = true; // mod folder removed or renamed
+        }
+
+        debounce.start(); // restart: wait until the folders are quiet
+    }
+
+    void ModWatcher::flush()
+    {
+        if(holds > 0) return;
+
+        const QSet<QString> mods = changedMods;
+        const bool list = listChanged, game = gameChanged;
+        changedMods.clear();
+        listChanged = gameChanged = false;
+
+        if(list) emit modsChanged();
+        if(game) emit mountChanged();
+        for(const QString &modName : mods) emit modChanged(modName);
+    }
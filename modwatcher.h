@@ -0,0 +1,50 @@
+#ifndef MODWATCHER_H
+#define MODWATCHER_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QSet>
+
+/* Keeps the mod list live without a manual refresh: watches the mods folder, every mod folder
+ * and the game folder (war3mod.mpq). QFileSystemWatcher isn't recursive, so a mod's subfolders are
+ * added once a scan has indexed them, up to `MAX_FOLDERS` per mod; deeper changes in larger mods
+ * are picked up by IndexedScan on the next refresh, which rescans every mod.
+ * Events are batched until the folders have been quiet for `DEBOUNCE_MS`; while held (an action is
+ * writing to these folders) they are only collected and delivered on the last release(). */
+class ModWatcher : public QObject
+{
+    Q_OBJECT
+
+               static const int DEBOUNCE_MS,
+                                MAX_FOLDERS; // subfolders watched per mod (a handle each, 63 per thread)
+
+               QFileSystemWatcher watcher;
+               QTimer             debounce;
+               QString            pathMods, pathGame;
+
+               QSet<QString> changedMods;
+               bool          listChanged = false, gameChanged = false;
+               int           holds = 0;
+
+public:        explicit ModWatcher(QObject *parent=nullptr);
+
+               void setPaths (const QString &pathMods, const QString &pathGame);
+               void watchMods(const QStringList &modNames);
+               void watchFolders(const QString &modName, const QStringList &folders); // relative to the mod
+
+               void hold() { ++holds; }
+               void release();
+
+signals:       void modsChanged();                      // mods added, removed or renamed
+               void modChanged(const QString &modName); // entries directly inside a mod folder
+               void mountChanged();                     // game folder: war3mod.mpq may have changed
+
+private slots: void directoryChanged(const QString &path);
+               void flush();
+
+private:       QString modOf(const QString &path) const { return path.mid(pathMods.length()+1).section('/', 0, 0); }
+               bool pending() const { return listChanged || gameChanged || !changedMods.isEmpty(); }
+};
+
+#endif // MODWATCHER_H
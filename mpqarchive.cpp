@@ -0,0 +1,295 @@
+#include "mpqarchive.h"
+
+#include <QStringList>
+#include <QRegExp>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+const quint32 MpqArchive::ID_MPQ           = 0x1A51504D, // "MPQ\x1A"
+              MpqArchive::ID_USER_DATA     = 0x1B51504D, // "MPQ\x1B"
+              MpqArchive::SEARCH_LIMIT     = 1024*1024,  // how far into the file the header is looked for
+              MpqArchive::HASH_FREE        = 0xFFFFFFFF,
+              MpqArchive::HASH_DELETED     = 0xFFFFFFFE,
+              MpqArchive::FLAG_IMPLODE     = 0x00000100,
+              MpqArchive::FLAG_COMPRESS    = 0x00000200,
+              MpqArchive::FLAG_ENCRYPTED   = 0x00010000,
+              MpqArchive::FLAG_FIX_KEY     = 0x00020000,
+              MpqArchive::FLAG_SINGLE_UNIT = 0x01000000,
+              MpqArchive::FLAG_SECTOR_CRC  = 0x04000000,
+              MpqArchive::FLAG_EXISTS      = 0x80000000;
+
+namespace {
+quint32 read32(const uchar *p) { return qFromLittleEndian<quint32>(p); }
+quint16 read16(const uchar *p) { return qFromLittleEndian<quint16>(p); }
+}
+
+MpqArchive::MpqArchive(const QString &path) : file(path)
+{
+    if(!open())
+    {
+        if(data) file.unmap(data);
+        data = nullptr;
+        hashes.clear();
+        blocks.clear();
+    }
+}
+
+MpqArchive::~MpqArchive()
+{ if(data) file.unmap(data); }
+
+const quint32 *MpqArchive::cryptTable()
+{
+    static const std::vector<quint32> table = []{
+        std::vector<quint32> table(0x500);
+        quint32 seed = 0x00100001;
+        for(quint32 i=0; i < 0x100; ++i)
+            for(quint32 j=i, k=0; k < 5; ++k, j += 0x100)
+            {
+                seed = (seed*125+3) % 0x2AAAAB;
+                const quint32 high = (seed & 0xFFFF) << 16;
+                seed = (seed*125+3) % 0x2AAAAB;
+                table[j] = high | (seed & 0xFFFF);
+            }
+        return table;
+    }();
+    return table.data();
+}
+
+quint32 MpqArchive::hashString(const QString &str, const quint32 type)
+{
+    const quint32 *table = cryptTable();
+    quint32 seed1 = 0x7FED7FED, seed2 = 0xEEEEEEEE;
+
+    for(uchar ch : str.toUtf8())
+    {
+        if(ch == '/') ch = '\\';
+        else if(ch >= 'a' && ch <= 'z') ch -= 'a'-'A'; // the game folds ASCII only
+        seed1 = table[type*0x100+ch] ^ (seed1+seed2);
+        seed2 = ch + seed1 + seed2 + (seed2 << 5) + 3;
+    }
+    return seed1;
+}
+
+void MpqArchive::decrypt(quint32 *block, size_t count, quint32 key)
+{
+    const quint32 *table = cryptTable();
+    quint32 seed = 0xEEEEEEEE;
+
+    for(; count; --count, ++block)
+    {
+        seed += table[0x400+(key & 0xFF)];
+        const quint32 ch = qFromLittleEndian(*block) ^ (key+seed);
+        key  = ((~key << 0x15) + 0x11111111) | (key >> 0x0B);
+        seed = ch + seed + (seed << 5) + 3;
+        *block = ch;
+    }
+}
+
+void MpqArchive::encrypt(quint32 *block, size_t count, quint32 key)
+{
+    const quint32 *table = cryptTable();
+    quint32 seed = 0xEEEEEEEE;
+
+    for(; count; --count, ++block)
+    {
+        seed += table[0x400+(key & 0xFF)];
+        const quint32 ch = *block;
+        *block = qToLittleEndian(ch ^ (key+seed));
+        key  = ((~key << 0x15) + 0x11111111) | (key >> 0x0B);
+        seed = ch + seed + (seed << 5) + 3;
+    }
+}
+
+bool MpqArchive::open()
+{
+    if(!file.open(QIODevice::ReadOnly)) return false;
+    dataSize = file.size();
+    if(dataSize < 32 || !(data = file.map(0, dataSize))) return false;
+
+    // The header sits at a multiple of 512, possibly behind user data pointing at it
+    const uchar *header = nullptr;
+    for(qint64 offset=0; offset+32 <= std::min(dataSize, qint64(SEARCH_LIMIT)); offset += 512)
+    {
+        const quint32 id = read32(data+offset);
+        if(id == ID_USER_DATA)
+        {
+            const qint64 target = offset+read32(data+offset+8);
+            if(target+32 <= dataSize && read32(data+target) == ID_MPQ)
+            {
+                archiveOffset = target;
+                header = data+target;
+                break;
+            }
+        }
+        else if(id == ID_MPQ)
+        {
+            archiveOffset = offset;
+            header = data+offset;
+            break;
+        }
+    }
+    if(!header) return false;
+
+    const quint32 headerSize = read32(header+4);
+    sectorSize = 512u << std::min(read16(header+14), quint16(20));
+
+    qint64 hashPos  = read32(header+16),
+           blockPos = read32(header+20);
+    if(headerSize >= 44 && archiveOffset+44 <= dataSize) // format 1: high 16 bits of the table offsets
+    {
+        hashPos  |= qint64(read16(header+40)) << 32;
+        blockPos |= qint64(read16(header+42)) << 32;
+    }
+
+    if(!readTable(hashPos,  read32(header+24), QStringLiteral(u"(hash table)"),  hashes)
+       || !readTable(blockPos, read32(header+28), QStringLiteral(u"(block table)"), blocks)
+       || hashes.empty()) return false;
+
+    special[0] = findBlock(QStringLiteral(u"(listfile)"));
+    special[1] = findBlock(QStringLiteral(u"(attributes)"));
+    special[2] = findBlock(QStringLiteral(u"(signature)"));
+    return true;
+}
+
+template<typename T>
+bool MpqArchive::readTable(const qint64 offset, const quint32 count, const QString &key, std::vector<T> &table)
+{
+    const qint64 pos = archiveOffset+offset;
+    if(pos < 0 || pos+qint64(count)*qint64(sizeof(T)) > dataSize) return false; // truncated or not an archive
+
+    table.resize(count);
+    std::memcpy(table.data(), data+pos, count*sizeof(T));
+    decrypt(reinterpret_cast<quint32*>(table.data()), count*sizeof(T)/4, hashString(key, 3));
+    return true;
+}
+
+int MpqArchive::findBlock(const QString &name) const
+{
+    const size_t size  = hashes.size(),
+                 start = hashString(name, 0) % size;
+    const quint32 nameA = hashString(name, 1), nameB = hashString(name, 2);
+
+    for(size_t i=start; ; )
+    {
+        const Hash &hash = hashes[i];
+        if(hash.block == HASH_FREE) return -1; // end of the chain
+
+        if(hash.nameA == nameA && hash.nameB == nameB && hash.block != HASH_DELETED && hash.block < blocks.size())
+            return int(hash.block);
+
+        if((i = (i+1) % size) == start) return -1;
+    }
+}
+
+QByteArray MpqArchive::readFile(const QString &name) const
+{
+    const int index = findBlock(name);
+    if(index < 0) return QByteArray();
+
+    const Block &block = blocks[size_t(index)];
+    const qint64 pos = archiveOffset+block.offset;
+    if(!(block.flags & FLAG_EXISTS) || pos+block.packed > dataSize
+       || (block.flags & FLAG_IMPLODE && !(block.flags & FLAG_COMPRESS))) return QByteArray(); // PKWARE only: not supported
+
+    quint32 key = 0;
+    if(block.flags & FLAG_ENCRYPTED)
+    {
+        key = hashString(name.mid(name.lastIndexOf('\\')+1), 3);
+        if(block.flags & FLAG_FIX_KEY) key = (key+block.offset) ^ block.size;
+    }
+
+    const bool   compressed = block.flags & FLAG_COMPRESS,
+                 single     = block.flags & FLAG_SINGLE_UNIT;
+    const quint32 sectors   = single ? 1 : (block.size+sectorSize-1)/sectorSize;
+
+    // Where each sector starts: a table in front of compressed data, fixed steps otherwise
+    std::vector<quint32> offsets(sectors+1);
+    if(single) offsets = { 0, block.packed };
+    else if(compressed)
+    {
+        if(qint64(offsets.size())*4 > block.packed) return QByteArray();
+        std::memcpy(offsets.data(), data+pos, offsets.size()*4);
+        if(block.flags & FLAG_ENCRYPTED) decrypt(offsets.data(), offsets.size(), key-1);
+    }
+    else for(quint32 i=0; i <= sectors; ++i) offsets[i] = std::min(i*sectorSize, block.size);
+
+    QByteArray result;
+    result.reserve(int(block.size));
+    for(quint32 i=0; i < sectors; ++i)
+    {
+        const quint32 begin = offsets[i], end = offsets[i+1],
+                      expected = single ? block.size : std::min(sectorSize, block.size-i*sectorSize);
+        if(end < begin || end > block.packed) return QByteArray();
+
+        QByteArray sector(reinterpret_cast<const char*>(data+pos+begin), int(end-begin));
+        if(block.flags & FLAG_ENCRYPTED) decrypt(reinterpret_cast<quint32*>(sector.data()), size_t(sector.size())/4, key+i);
+
+        if(compressed && quint32(sector.size()) < expected)
+        {
+            if(sector.isEmpty() || uchar(sector[0]) != 0x02) return QByteArray(); // zlib only
+
+            QByteArray zlib(4, 0);
+            qToBigEndian(expected, reinterpret_cast<uchar*>(zlib.data())); // the length qUncompress expects first
+            zlib += sector.mid(1);
+            sector = qUncompress(zlib);
+            if(quint32(sector.size()) != expected) return QByteArray();
+        }
+        result += sector;
+    }
+
+    return quint32(result.size()) == block.size ? result : QByteArray();
+}
+
+int MpqArchive::fileCount() const
+{
+    int count = 0;
+    for(size_t i=0; i < blocks.size(); ++i)
+        if(blocks[i].flags & FLAG_EXISTS && !isSpecial(i)) ++count;
+    return count;
+}
+
+qint64 MpqArchive::unpackedSize() const
+{
+    qint64 size = 0;
+    for(size_t i=0; i < blocks.size(); ++i)
+        if(blocks[i].flags & FLAG_EXISTS && !isSpecial(i)) size += blocks[i].size;
+    return size;
+}
+
+std::vector<MpqArchive::Entry> MpqArchive::entries() const
+{
+    std::vector<QString> names(blocks.size());
+    const QString &listfile = QString::fromUtf8(readFile(QStringLiteral(u"(listfile)")));
+    for(const QString &name : listfile.split(QRegExp(QStringLiteral(u"[;\r\n]")), QString::SkipEmptyParts))
+    {
+        const int block = findBlock(name);
+        if(block >= 0) names[size_t(block)] = name;
+    }
+
+    std::vector<Entry> entries;
+    for(size_t i=0; i < blocks.size(); ++i)
+        if(blocks[i].flags & FLAG_EXISTS && !isSpecial(i))
+        {
+            Entry entry;
+            entry.name   = names[i];
+            entry.size   = blocks[i].size;
+            entry.packed = blocks[i].packed;
+            entries.push_back(std::move(entry));
+        }
+    return entries;
+}
+
+bool MpqArchive::isArchive(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) return false;
+
+    const QByteArray &head = file.read(SEARCH_LIMIT);
+    for(int offset=0; offset+4 <= head.size(); offset += 512)
+    {
+        const quint32 id = read32(reinterpret_cast<const uchar*>(head.constData())+offset);
+        if(id == ID_MPQ || id == ID_USER_DATA) return true;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#ifndef MPQARCHIVE_H
+#define MPQARCHIVE_H
+
+#include <QFile>
+#include <vector>
+
+/* Read-only view of an MPQ archive (a packed mod, or a war3mod.mpq that is a real archive).
+ * The whole archive is memory-mapped; the hash and block tables are decrypted once on open and
+ * the block table alone gives file count and unpacked size, so sizing reads nothing else.
+ * Names come from (listfile), which is read (and unpacked, zlib sectors only) when entries() is called. */
+class MpqArchive
+{
+         friend class MpqWriter; // same tables, written instead of read
+
+public:  struct Entry {
+             QString name;         // from (listfile); empty when the archive doesn't list it
+             qint64  size   = 0,   // unpacked
+                     packed = 0;
+         };
+
+private: struct Hash  { quint32 nameA, nameB; quint16 locale, platform; quint32 block; };
+         struct Block { quint32 offset, packed, size, flags; };
+
+         static const quint32 ID_MPQ, ID_USER_DATA, SEARCH_LIMIT,
+                              HASH_FREE, HASH_DELETED,
+                              FLAG_IMPLODE, FLAG_COMPRESS, FLAG_ENCRYPTED, FLAG_FIX_KEY, FLAG_SINGLE_UNIT,
+                              FLAG_SECTOR_CRC, FLAG_EXISTS;
+
+         QFile  file;
+         uchar  *data = nullptr;
+         qint64 dataSize = 0,
+                archiveOffset = 0; // the header can follow a map header or user data, at any multiple of 512
+         quint32 sectorSize = 0;
+         std::vector<Hash>  hashes;
+         std::vector<Block> blocks;
+         int special[3] = { -1, -1, -1 }; // blocks of (listfile), (attributes), (signature): not mod files
+
+         static const quint32 *cryptTable();
+         static quint32 hashString(const QString &str, const quint32 type);
+         static void    decrypt(quint32 *block, size_t count, quint32 key);
+         static void    encrypt(quint32 *block, size_t count, quint32 key);
+
+         bool open();
+         template<typename T> bool readTable(const qint64 offset, const quint32 count, const QString &key, std::vector<T> &table);
+         int        findBlock(const QString &name) const; // -1: not in the archive
+         QByteArray readFile (const QString &name) const;
+         bool       isSpecial(const size_t block) const
+         { return int(block) == special[0] || int(block) == special[1] || int(block) == special[2]; }
+
+public:  explicit MpqArchive(const QString &path);
+         ~MpqArchive();
+         MpqArchive(const MpqArchive&) = delete;
+         MpqArchive &operator=(const MpqArchive&) = delete;
+
+         bool isOpen() const { return data; }
+
+         int    fileCount()    const;
+         qint64 unpackedSize() const;
+         std::vector<Entry> entries() const;
+
+         static bool isArchive(const QString &path); // header check only
+         static bool isPacked (const QString &fileName) // a packed mod: <name>.mpq in the mods folder
+         { return fileName.endsWith(QLatin1String(".mpq"), Qt::CaseInsensitive); }
+};
+
+#endif // MPQARCHIVE_H
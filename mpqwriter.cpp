@@ -0,0 +1,305 @@
+#include "mpqwriter.h"
+#include "mpqarchive.h"
+
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
+#include <QWaitCondition>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+struct Chunk { size_t file; qint64 offset; quint32 sectors; }; // `sectors` sectors of files[file] from `offset`
+
+/* Chunk i is compressed into slot i % window once the writer has taken chunk i-window out of it */
+struct Pipeline
+{
+    const std::vector<MpqWriter::File> &files;
+    std::vector<Chunk> chunks;
+    const size_t window;
+    std::vector<std::vector<QByteArray>> slots;
+    std::vector<char> ready;
+    size_t next = 0, written = 0;
+    bool stop = false;
+    QString failedPath;
+    QMutex mutex;
+    QWaitCondition changed;
+    QAtomicInteger<qint64> done = 0;
+
+    Pipeline(const std::vector<MpqWriter::File> &files, const size_t window)
+        : files(files), window(window), slots(window), ready(window, 0) {}
+};
+
+class PackJob : public QRunnable
+{
+    Pipeline &pipe;
+
+public:
+    explicit PackJob(Pipeline &pipe) : pipe(pipe) {}
+
+    void run() override
+    {
+        QFile file;
+        size_t opened = pipe.files.size();
+
+        for(;;)
+        {
+            size_t i;
+            {
+                QMutexLocker lock(&pipe.mutex);
+                while(!pipe.stop && pipe.next < pipe.chunks.size() && pipe.next >= pipe.written+pipe.window)
+                    pipe.changed.wait(&pipe.mutex);
+                if(pipe.stop || pipe.next >= pipe.chunks.size()) return;
+                i = pipe.next++;
+            }
+
+            const Chunk &chunk = pipe.chunks[i];
+            const MpqWriter::File &src = pipe.files[chunk.file];
+            const qint64 len = std::min(qint64(chunk.sectors)*MpqWriter::SECTOR_SIZE, src.size-chunk.offset);
+
+            bool ok = true;
+            if(chunk.file != opened) // consecutive chunks of a large file mostly go to the same job
+            {
+                file.close();
+                file.setFileName(src.path);
+                ok = file.open(QIODevice::ReadOnly);
+                opened = chunk.file;
+            }
+
+            std::vector<QByteArray> sectors;
+            if(len > 0)
+            {
+                const QByteArray &data = ok && file.seek(chunk.offset) ? file.read(len) : QByteArray();
+                ok = data.size() == len;
+                if(ok)
+                    for(qint64 pos=0; pos < len; pos += MpqWriter::SECTOR_SIZE)
+                        sectors.push_back(MpqWriter::compress(data.constData()+pos, int(std::min(MpqWriter::SECTOR_SIZE, len-pos))));
+                pipe.done.fetchAndAddRelaxed(len);
+            }
+
+            QMutexLocker lock(&pipe.mutex);
+            if(!ok && !pipe.stop)
+            {
+                pipe.stop = true;
+                pipe.failedPath = src.path;
+            }
+            pipe.slots[i % pipe.window] = std::move(sectors);
+            pipe.ready[i % pipe.window] = 1;
+            pipe.changed.wakeAll();
+        }
+    }
+};
+
+void write32(QByteArray &out, const quint32 value)
+{
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char*>(bytes), 4);
+}
+}
+
+quint32 MpqWriter::hashTableSize(const size_t count)
+{
+    quint32 size = 16;
+    while(size < count*4/3+1) size <<= 1;
+    return size;
+}
+
+QByteArray MpqWriter::compress(const char *data, const int size)
+{
+    const QByteArray &zlib = qCompress(reinterpret_cast<const uchar*>(data), size); // big endian length first
+    if(zlib.size()-4+1 >= size) return QByteArray(data, size); // doesn't shrink: stored, the game reads a full sector as is
+
+    QByteArray sector(1, char(0x02)); // compression mask: zlib
+    sector.append(zlib.constData()+4, zlib.size()-4);
+    return sector;
+}
+
+MpqWriter::Result MpqWriter::pack(const QString &path, const std::vector<File> &files, const Progress &progress,
+                                  QString *failedPath)
+{
+    const int threads = std::max(QThread::idealThreadCount(), 1);
+    Pipeline pipe(files, size_t(threads)*WINDOW_PER_THREAD);
+
+    qint64 total = 0;
+    for(size_t i=0; i < files.size(); ++i)
+    {
+        const qint64 sectors = (files[i].size+SECTOR_SIZE-1)/SECTOR_SIZE;
+        if(sectors == 0) pipe.chunks.push_back({ i, 0, 0 }); // still one block
+        for(qint64 first=0; first < sectors; first += CHUNK_SECTORS)
+            pipe.chunks.push_back({ i, first*SECTOR_SIZE, quint32(std::min(qint64(CHUNK_SECTORS), sectors-first)) });
+        total += files[i].size;
+    }
+
+    QSaveFile out(path);
+    if(!out.open(QIODevice::WriteOnly)) return Failed;
+    out.write(QByteArray(32, 0)); // header, once the tables are placed
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for(int i=0; i < threads && size_t(i) < pipe.chunks.size(); ++i) pool.start(new PackJob(pipe));
+
+    auto halt = [&pipe, &pool]{
+        {
+            QMutexLocker lock(&pipe.mutex);
+            pipe.stop = true;
+            pipe.changed.wakeAll();
+        }
+        pool.waitForDone();
+    };
+
+    // Blocks are written in file order; each starts with its sector offset table, filled in once its last chunk is in
+    std::vector<MpqArchive::Block> blocks(files.size()+1); // + (listfile)
+    std::vector<quint32> offsets;
+    QElapsedTimer timer;
+    timer.start();
+
+    auto writeSectors = [&out, &offsets](const std::vector<QByteArray> &sectors) {
+        for(const QByteArray &sector : sectors)
+        {
+            out.write(sector);
+            offsets.push_back(offsets.back()+quint32(sector.size()));
+        }
+    };
+    auto writeOffsets = [&out, &offsets](const MpqArchive::Block &block) {
+        QByteArray table;
+        for(const quint32 offset : offsets) write32(table, offset);
+        const qint64 end = out.pos();
+        return out.seek(block.offset) && out.write(table) == table.size() && out.seek(end);
+    };
+
+    for(size_t w=0; w < pipe.chunks.size(); ++w)
+    {
+        std::vector<QByteArray> sectors;
+        for(bool taken = false; !taken; )
+        {
+            {
+                QMutexLocker lock(&pipe.mutex);
+                if(!pipe.ready[w % pipe.window] && !pipe.stop) pipe.changed.wait(&pipe.mutex, 50);
+                if(pipe.stop)
+                {
+                    lock.unlock();
+                    halt();
+                    if(pipe.failedPath.isEmpty()) return Cancelled;
+                    if(failedPath) *failedPath = pipe.failedPath;
+                    return Failed;
+                }
+                if((taken = pipe.ready[w % pipe.window]))
+                {
+                    sectors = std::move(pipe.slots[w % pipe.window]);
+                    pipe.ready[w % pipe.window] = 0;
+                    pipe.written = w+1;
+                    pipe.changed.wakeAll();
+                }
+            }
+            if(progress && timer.hasExpired(50))
+            {
+                timer.restart();
+                if(!progress(pipe.done.loadAcquire(), total))
+                {
+                    halt();
+                    return Cancelled;
+                }
+            }
+        }
+
+        const Chunk &chunk = pipe.chunks[w];
+        const File &file = files[chunk.file];
+        MpqArchive::Block &block = blocks[chunk.file];
+        const quint32 count = quint32((file.size+SECTOR_SIZE-1)/SECTOR_SIZE);
+
+        if(chunk.offset == 0)
+        {
+            block.offset = quint32(out.pos());
+            offsets.assign(1, count ? (count+1)*4 : 0);
+            if(count) out.write(QByteArray(int(offsets[0]), 0));
+        }
+        writeSectors(sectors);
+
+        if(chunk.offset+qint64(chunk.sectors)*SECTOR_SIZE >= file.size) // last chunk of the file
+        {
+            block.size   = quint32(file.size);
+            block.packed = offsets.back();
+            block.flags  = MpqArchive::FLAG_EXISTS | (count ? MpqArchive::FLAG_COMPRESS : 0);
+            if(count && !writeOffsets(block))
+            {
+                halt();
+                return Failed;
+            }
+        }
+
+        if(out.pos() > 0xFFFFFFFFLL || file.size > 0xFFFFFFFFLL) // format 0 has 32-bit offsets
+        {
+            halt();
+            return TooLarge;
+        }
+    }
+    pool.waitForDone();
+
+    // (listfile): the names, so readers can tell what each block is
+    QStringList names;
+    for(const File &file : files) names << file.name;
+    const QByteArray &listfile = names.join("\r\n").toUtf8();
+    {
+        MpqArchive::Block &block = blocks.back();
+        const quint32 count = quint32((listfile.size()+SECTOR_SIZE-1)/SECTOR_SIZE);
+        std::vector<QByteArray> sectors;
+        for(qint64 pos=0; pos < listfile.size(); pos += SECTOR_SIZE)
+            sectors.push_back(compress(listfile.constData()+pos, int(std::min(SECTOR_SIZE, qint64(listfile.size())-pos))));
+
+        block.offset = quint32(out.pos());
+        offsets.assign(1, count ? (count+1)*4 : 0);
+        if(count) out.write(QByteArray(int(offsets[0]), 0));
+        writeSectors(sectors);
+        block.size   = quint32(listfile.size());
+        block.packed = offsets.back();
+        block.flags  = MpqArchive::FLAG_EXISTS | (count ? MpqArchive::FLAG_COMPRESS : 0);
+        if(count && !writeOffsets(block)) return Failed;
+    }
+
+    // Hash table: open addressing from the name's hash, as the game looks names up
+    const quint32 hashCount = hashTableSize(blocks.size());
+    std::vector<MpqArchive::Hash> hashes(hashCount, { MpqArchive::HASH_FREE, MpqArchive::HASH_FREE, 0xFFFF, 0xFFFF,
+                                                      MpqArchive::HASH_FREE });
+    for(size_t i=0; i < blocks.size(); ++i)
+    {
+        const QString &name = i < files.size() ? files[i].name : QStringLiteral(u"(listfile)");
+        quint32 slot = MpqArchive::hashString(name, 0) & (hashCount-1);
+        while(hashes[slot].block != MpqArchive::HASH_FREE) slot = (slot+1) & (hashCount-1);
+
+        MpqArchive::Hash &hash = hashes[slot];
+        hash.nameA    = MpqArchive::hashString(name, 1);
+        hash.nameB    = MpqArchive::hashString(name, 2);
+        hash.locale   = 0; // neutral
+        hash.platform = 0;
+        hash.block    = quint32(i);
+    }
+
+    const qint64 hashPos = out.pos(), blockPos = hashPos+qint64(hashCount)*16,
+                 end = blockPos+qint64(blocks.size())*16;
+    if(end > 0xFFFFFFFFLL) return TooLarge;
+
+    MpqArchive::encrypt(reinterpret_cast<quint32*>(hashes.data()), hashes.size()*4,
+                        MpqArchive::hashString(QStringLiteral(u"(hash table)"), 3));
+    MpqArchive::encrypt(reinterpret_cast<quint32*>(blocks.data()), blocks.size()*4,
+                        MpqArchive::hashString(QStringLiteral(u"(block table)"), 3));
+    out.write(reinterpret_cast<const char*>(hashes.data()), qint64(hashes.size()*sizeof(MpqArchive::Hash)));
+    out.write(reinterpret_cast<const char*>(blocks.data()), qint64(blocks.size()*sizeof(MpqArchive::Block)));
+
+    QByteArray header;
+    write32(header, MpqArchive::ID_MPQ);
+    write32(header, 32);
+    write32(header, quint32(end));
+    write32(header, quint32(SECTOR_SHIFT) << 16); // format 0, then the sector size shift
+    write32(header, quint32(hashPos));
+    write32(header, quint32(blockPos));
+    write32(header, hashCount);
+    write32(header, quint32(blocks.size()));
+    if(!out.seek(0) || out.write(header) != header.size()) return Failed;
+
+    return out.commit() ? Packed : Failed;
+}
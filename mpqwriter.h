@@ -0,0 +1,35 @@
+#ifndef MPQWRITER_H
+#define MPQWRITER_H
+
+#include <QString>
+#include <functional>
+#include <vector>
+
+/* Packs files into a new MPQ archive the way the game reads war3mod.mpq: format 0, 4 KB sectors, zlib.
+ * Files are cut into chunks of CHUNK_SECTORS sectors that all cores compress; the calling thread writes the
+ * chunks in order as they come in, and no more than WINDOW_PER_THREAD chunks per core are ever in flight,
+ * so memory stays the same whatever the size of the mod. The hash table is sized from the file count.
+ * `progress` is called about every 50 ms with bytes read and total; returning false cancels (nothing is written). */
+class MpqWriter
+{
+public:  struct File {
+             QString name, // in the archive, '\\'-separated
+                     path;
+             qint64  size = 0;
+         };
+         enum Result { Failed, Cancelled, TooLarge, Packed };
+         typedef std::function<bool(const qint64 done, const qint64 total)> Progress;
+
+         static constexpr quint16 SECTOR_SHIFT      = 3;                   // 512 << 3: what the game's own archives use
+         static constexpr qint64  SECTOR_SIZE       = 512 << SECTOR_SHIFT;
+         static constexpr quint32 CHUNK_SECTORS     = 64,                  // 256 KB per job
+                                  WINDOW_PER_THREAD = 4;
+
+         static Result pack(const QString &path, const std::vector<File> &files, const Progress &progress=nullptr,
+                            QString *failedPath=nullptr); // failedPath: the file that couldn't be read
+
+         static quint32    hashTableSize(const size_t count); // power of two, at most 3/4 full
+         static QByteArray compress(const char *data, const int size);
+};
+
+#endif // MPQWRITER_H
@@ -0,0 +1,138 @@
+#define WINVER _WIN32_WINNT_WIN7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "overlay.h"
+#include "threadbase.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <windef.h>  // winbase.h needs to be
+#include <winbase.h> // preceded by windef.h
+
+const quint32 Overlay::MAGIC   = 0x574d4d4f, // "WMMO"
+              Overlay::VERSION = 1;
+
+QString Overlay::sharedPath;
+
+/********************************************************************/
+/*      OVERLAY     *************************************************/
+/********************************************************************/
+    QString Overlay::path()
+    { return sharedPath.isEmpty() ? QCoreApplication::applicationDirPath()+"/overlay.idx" : sharedPath; }
+
+    QString Overlay::mountedMod()
+    {
+        QFile file(path());
+        if(!file.open(QIODevice::ReadOnly)) return QString();
+
+        QDataStream in(&file);
+        quint32 magic, version;
+        QString modName;
+        in >> magic >> version >> modName;
+
+        return in.status() == QDataStream::Ok && magic == MAGIC && version == VERSION ? modName : QString();
+    }
+
+    bool Overlay::remove()
+    { return !QFileInfo::exists(path()) || QFile::remove(path()); }
+
+    bool Overlay::load()
+    {
+        QFile file(path());
+        if(!file.open(QIODevice::ReadOnly)) return false;
+
+        QDataStream in(&file);
+        quint32 magic, version, fileCount;
+        in >> magic >> version;
+        if(magic != MAGIC || version != VERSION) return false;
+
+        in >> modName >> modRoot >> gameRoot >> dirs >> fileCount;
+        files.clear();
+        files.reserve(fileCount);
+        for(quint32 i=0; i < fileCount && in.status() == QDataStream::Ok; ++i)
+        {
+            Entry entry;
+            quint8 kind;
+            in >> entry.rel >> kind;
+            entry.kind = Kind(kind);
+            files.push_back(std::move(entry));
+        }
+
+        return in.status() == QDataStream::Ok;
+    }
+
+    bool Overlay::save() const
+    {
+        QSaveFile file(path());
+        if(!file.open(QIODevice::WriteOnly)) return false;
+
+        QDataStream out(&file);
+        out << MAGIC << VERSION << modName << modRoot << gameRoot << dirs << quint32(files.size());
+        for(const Entry &entry : files) out << entry.rel << quint8(entry.kind);
+
+        return file.commit();
+    }
+
+    Overlay::Result Overlay::link(const QString &src, const QString &dst, const bool sameVolume, Kind &kind)
+    {
+        const std::wstring wSrc = QDir::toNativeSeparators(src).toStdWString(),
+                           wDst = QDir::toNativeSeparators(dst).toStdWString();
+
+        if(CreateSymbolicLink(wDst.c_str(), wSrc.c_str(), kind == DirLink ? SYMBOLIC_LINK_FLAG_DIRECTORY : 0x0))
+        {
+            if(kind != DirLink) kind = SymLink;
+            return Done;
+        }
+
+        DWORD error = GetLastError();
+        if(error == ERROR_PRIVILEGE_NOT_HELD && sameVolume && kind != DirLink)
+        {
+            if(CreateHardLink(wDst.c_str(), wSrc.c_str(), nullptr))
+            {
+                kind = HardLink;
+                return Done;
+            }
+            error = GetLastError();
+        }
+
+        return error == ERROR_ALREADY_EXISTS || error == ERROR_FILE_EXISTS ? Exists : Failed;
+    }
+
+    Overlay::Result Overlay::unlink(const QString &src, const QString &dst, const Kind kind)
+    {
+        const QFileInfo fiDst(dst);
+        if(!fiDst.isSymLink() && !fiDst.exists()) return Missing;
+
+        // Whatever replaced the link since the mount isn't ours to delete
+        if(kind == HardLink ? fiDst.isSymLink() || ThreadBase::fileId(dst) != ThreadBase::fileId(src)
+                            : !fiDst.isSymLink() || fiDst.symLinkTarget() != QFileInfo(src).absoluteFilePath())
+            return Exists;
+
+        const std::wstring wDst = QDir::toNativeSeparators(dst).toStdWString();
+        return (kind == DirLink ? RemoveDirectory(wDst.c_str()) : DeleteFile(wDst.c_str())) ? Done : Failed;
+    }
+
+/********************************************************************/
+/*      OVERLAY JOB     *********************************************/
+/********************************************************************/
+    void OverlayJob::run()
+    {
+        for(size_t i=begin; i < end && !stop.loadAcquire(); ++i)
+        {
+            Overlay::Entry &entry = overlay.files[i];
+            const QString &src = overlay.modRoot+"/"+entry.rel,
+                          &dst = overlay.gameRoot+"/"+entry.rel;
+
+            results[i] = unlinking ? Overlay::unlink(src, dst, entry.kind)
+                                   : Overlay::link(src, dst, sameVolume, entry.kind);
+            done.ref();
+        }
+    }
@@ -0,0 +1,59 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <QStringList>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <vector>
+
+/* Per-file mount, for mods that have to place files next to the game's own: instead of linking the mod folder
+ * as war3mod.mpq, every file of the mod is linked into the game folder. Links are made and removed in parallel
+ * batches (OverlayJob); the manifest (overlay.idx) records each link, the folders the mount had to create
+ * and which mod they belong to, so Unmount can undo exactly that. */
+class Overlay
+{
+public:  enum Kind : quint8 { SymLink, HardLink, DirLink };   // HardLink: no symlink privilege, same volume
+         enum Result : quint8 { Done, Exists, Failed, Missing, Skipped };
+         struct Entry {
+             QString rel;               // relative to modRoot and gameRoot
+             Kind    kind = SymLink;
+         };
+         static constexpr size_t BATCH = 256;
+
+         QString            modName, modRoot, gameRoot;
+         std::vector<Entry> files;
+         QStringList        dirs;       // created by the mount, parents first
+
+private: static const quint32 MAGIC, VERSION;
+         static QString sharedPath;
+
+public:  static void    setPath(const QString &path) { sharedPath = path; }
+         static QString path();
+         static QString mountedMod();   // empty: no overlay mounted
+         static bool    remove();
+
+         bool load();
+         bool save() const;
+
+         static Result link  (const QString &src, const QString &dst, const bool sameVolume, Kind &kind);
+         static Result unlink(const QString &src, const QString &dst, const Kind kind); // only what link() made (Exists: replaced)
+};
+
+/* Links or unlinks files [begin, end) of an Overlay; each job only writes its own range of `results` */
+class OverlayJob : public QRunnable
+{
+               Overlay                      &overlay;
+               std::vector<Overlay::Result> &results;
+               const size_t                 begin, end;
+               const bool                   unlinking, sameVolume;
+               QAtomicInt                   &stop, &done;
+
+public:        OverlayJob(Overlay &overlay, std::vector<Overlay::Result> &results, const size_t begin, const size_t end,
+                          const bool unlinking, const bool sameVolume, QAtomicInt &stop, QAtomicInt &done)
+                   : overlay(overlay), results(results), begin(begin), end(end),
+                     unlinking(unlinking), sameVolume(sameVolume), stop(stop), done(done) {}
+
+               void run() override;
+};
+
+#endif // OVERLAY_H
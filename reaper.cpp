@@ -0,0 +1,97 @@
+#define WINVER _WIN32_WINNT_WIN7
+#ifdef _WIN32_WINNT
+    #undef _WIN32_WINNT
+#endif
+#define _WIN32_WINNT _WIN32_WINNT_WIN7
+
+#include "reaper.h"
+
+#include <QDirIterator>
+#include <QDateTime>
+#include <QRunnable>
+#include <QThread>
+#include <QAtomicInt>
+#include <memory>
+
+#include <windef.h>  // winbase.h needs to be
+#include <winbase.h> // preceded by windef.h
+
+const QString Reaper::TRASH = QStringLiteral(u".trash");
+
+namespace {
+class ReapJob : public QRunnable
+{
+    Reaper *const reaper;
+    const QString tombstone, path;
+    const std::shared_ptr<QAtomicInt> pending; // jobs left for this tombstone
+
+public:
+    ReapJob(Reaper *const reaper, const QString &tombstone, const QString &path, std::shared_ptr<QAtomicInt> pending)
+        : reaper(reaper), tombstone(tombstone), path(path), pending(std::move(pending)) {}
+
+    void run() override
+    {
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+
+        const QFileInfo &fi(path);
+        if(fi.isDir() && !fi.isSymLink()) QDir(path).removeRecursively();
+        else QFile::remove(path); // files and links: never follow a link out of the trash
+
+        if(!pending->deref()) // last job: the tombstone itself
+        {
+            QDir(tombstone).removeRecursively();
+            QMetaObject::invokeMethod(reaper, "tombstoneDone", Qt::QueuedConnection, Q_ARG(QString, tombstone));
+        }
+    }
+};
+}
+
+/********************************************************************/
+/*      REAPER      *************************************************/
+/********************************************************************/
+    Reaper::Reaper(const QString &pathMods, QObject *parent) : QObject(parent),
+        pathTrash(pathMods+"/"+TRASH)
+    {
+        pool.setMaxThreadCount(std::max(QThread::idealThreadCount()/2, 2));
+    }
+
+    Reaper::~Reaper()
+    {
+        pool.clear();           // queued jobs: done on the next start
+        pool.waitForDone();     // running jobs can't be interrupted
+    }
+
+    QString Reaper::bury(const QString &pathMods, const QString &modName)
+    {
+        const QString &pathTrash = pathMods+"/"+TRASH;
+        if(!QDir().mkpath(pathTrash)) return QString();
+        SetFileAttributesW(QDir::toNativeSeparators(pathTrash).toStdWString().c_str(),
+                           FILE_ATTRIBUTE_HIDDEN|FILE_ATTRIBUTE_DIRECTORY); // keeps it out of the mod list
+
+        const QString &tombstone = pathTrash+"/"+modName+"."+QString::number(QDateTime::currentMSecsSinceEpoch());
+        if(MoveFileExW(QDir::toNativeSeparators(pathMods+"/"+modName).toStdWString().c_str(),
+                       QDir::toNativeSeparators(tombstone).toStdWString().c_str(), 0)) // same folder tree: a rename
+            return tombstone;
+
+        return QString();
+    }
+
+    void Reaper::reap()
+    {
+        for(QDirIterator itTrash(pathTrash, QDir::NoDotAndDotDot|QDir::AllEntries|QDir::Hidden|QDir::System);
+            itTrash.hasNext(); )
+        {
+            const QString &tombstone = itTrash.next();
+            if(reaping.contains(tombstone)) continue;
+
+            QStringList entries;
+            for(QDirIterator itTomb(tombstone, QDir::NoDotAndDotDot|QDir::AllEntries|QDir::Hidden|QDir::System);
+                itTomb.hasNext(); ) entries << itTomb.next();
+
+            if(entries.isEmpty()) entries << tombstone; // empty folder or stray file: one job removes it
+
+            reaping.insert(tombstone);
+            std::shared_ptr<QAtomicInt> pending = std::make_shared<QAtomicInt>(entries.length());
+            for(const QString &entry : entries) pool.start(new ReapJob(this, tombstone, entry, pending));
+        }
+    }
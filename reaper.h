@@ -0,0 +1,32 @@
+#ifndef REAPER_H
+#define REAPER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QSet>
+
+/* Deleting a mod is one rename into the hidden mods/.trash folder (bury(), any thread),
+ * after which the mod is gone for the UI. reap() then removes the tombstones on a small pool
+ * of low priority threads, one job per top level entry. Tombstones left by a previous run
+ * (crash, shutdown mid-reap) are picked up by the first reap(). */
+class Reaper : public QObject
+{
+    Q_OBJECT
+
+public:        static const QString TRASH;
+
+private:       const QString pathTrash;
+               QThreadPool   pool;
+               QSet<QString> reaping; // tombstones with jobs in flight (GUI thread only)
+
+public:        explicit Reaper(const QString &pathMods, QObject *parent=nullptr);
+               ~Reaper();
+
+               static QString bury(const QString &pathMods, const QString &modName); // tombstone path, empty on failure
+
+public slots:  void reap();
+
+private slots: void tombstoneDone(const QString &path) { reaping.remove(path); }
+};
+
+#endif // REAPER_H
@@ -0,0 +1,253 @@
+#include "scanengine.h"
+#include "dirlister.h"
+#include "mpqarchive.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+
+/********************************************************************/
+/*      SCAN ENGINE     *********************************************/
+/********************************************************************/
+    ScanEngine::ScanEngine(const QString &indexPath, QObject *parent) : ThreadBase(),
+        index(indexPath)
+    {
+        setParent(parent);
+
+        saveTimer.setSingleShot(true);
+        saveTimer.setInterval(1000);
+        connect(&saveTimer, &QTimer::timeout,           this, &ScanEngine::saveIndex);
+        connect(this,       &ScanEngine::scanModReady,  this, [this]{ saveTimer.start(); });
+
+        const int count = std::max(QThread::idealThreadCount(), 1);
+        workers.reserve(size_t(count));
+        for(int i=0; i < count; ++i)
+        {
+            workers.emplace_back(new ScanWorker(this, i));
+            workers.back()->start();
+        }
+    }
+
+    ScanEngine::~ScanEngine()
+    {
+        cancelAll();
+
+        idleMutex.lock();
+        stopping.storeRelease(1);
+        idleWait.wakeAll();
+        idleMutex.unlock();
+
+        for(std::unique_ptr<ScanWorker> &worker : workers) worker->wait();
+
+        saveTimer.stop();
+        index.save();
+    }
+
+    void ScanEngine::scan(const QString &modName, const QString &path, const ThreadAction::ScanMode &mode,
+                          const QStringList &skip)
+    {
+        std::shared_ptr<ModScan> &mod = active[modName];
+        if(mod) mod->cancelled.storeRelease(1);
+
+        mod = std::make_shared<ModScan>(modName, path, mode == ThreadAction::IndexedScan ? index.tree(path) : nullptr, skip);
+        push({ mod, path, QString() });
+    }
+
+    void ScanEngine::cancel(const QString &modName)
+    {
+        auto it = active.find(modName);
+        if(it != active.end())
+        {
+            it->second->cancelled.storeRelease(1);
+            active.erase(it);
+        }
+    }
+
+    void ScanEngine::cancelAll()
+    {
+        for(std::pair<const QString, std::shared_ptr<ModScan> > &mod : active)
+            mod.second->cancelled.storeRelease(1);
+        active.clear();
+    }
+
+    void ScanEngine::pruneIndex(const QStringList &roots)
+    {
+        QStringList keep = roots;
+        for(const std::pair<const QString, std::shared_ptr<ModScan> > &mod : active)
+            keep << mod.second->root;
+
+        index.retain(keep);
+        saveTimer.start();
+    }
+
+    void ScanEngine::push(Task &&task, const int worker)
+    {
+        queued.ref(); // before the task is visible, so waitForWork() can't miss it
+
+        workers[size_t(worker >= 0 ? worker
+                                   : int(unsigned(nextWorker.fetchAndAddRelaxed(1)) % workers.size()))]
+            ->push(std::move(task));
+
+        idleMutex.lock();
+        idleWait.wakeOne();
+        idleMutex.unlock();
+    }
+
+    bool ScanEngine::steal(const int thief, Task &task)
+    {
+        for(size_t i=1; i < workers.size(); ++i)
+            if(workers[(size_t(thief)+i) % workers.size()]->steal(task)) return true;
+
+        return false;
+    }
+
+    bool ScanEngine::waitForWork()
+    {
+        QMutexLocker lock(&idleMutex);
+        if(!stopping.loadAcquire() && queued.loadAcquire() <= 0) idleWait.wait(&idleMutex);
+
+        return !stopping.loadAcquire();
+    }
+
+    void ScanEngine::process(const Task &task, const int worker)
+    {
+        ModScan &mod = *task.mod;
+        int files = 0; // what this task adds, so the throttle counts files rather than folders
+
+        if(!mod.cancelled.loadAcquire())
+        {
+            const QFileInfo &fi(task.path);
+            if(fi.isSymLink() || !fi.isDir())
+            {
+                const MpqArchive mpq(fi.isSymLink() ? fi.symLinkTarget() : task.path);
+                if(mpq.isOpen()) // packed mod: sized from its block table, nothing is extracted
+                {
+                    files = mpq.fileCount();
+                    mod.size.fetchAndAddRelaxed(mpq.unpackedSize());
+                    mod.fileCount.fetchAndAddRelaxed(files);
+                    for(const MpqArchive::Entry &entry : mpq.entries())
+                        if(!entry.name.isEmpty()) mod.packed << entry.name; // a root task is the mod's only one
+                }
+                else
+                {
+                    int links = 0;
+                    files = 1;
+                    mod.size.fetchAndAddRelaxed(fileSize(fi, &links));
+                    mod.fileCount.ref();
+                    mod.links.fetchAndAddRelaxed(links);
+                }
+            }
+            else
+            {
+                ModIndex::Dir dir;
+                dir.mtime = fi.lastModified().toMSecsSinceEpoch();
+
+                ModIndex::Tree::const_iterator itCached;
+                if(mod.cached && (itCached = mod.cached->find(task.rel)) != mod.cached->end()
+                              && itCached->second.mtime == dir.mtime)
+                    dir = itCached->second; // folder unchanged: trust the index
+
+                else
+                {
+                    DirLister::Entry entry;
+                    for(DirLister lister(task.path); !mod.cancelled.loadAcquire() && lister.next(entry); )
+                    {
+                        if(mod.skips(task.rel.isEmpty() ? entry.name : task.rel+"/"+entry.name)) continue;
+                        if(entry.link) // only links need a QFileInfo
+                        {
+                            const QFileInfo &fiEntry(task.path+"/"+entry.name);
+                            if(!fiEntry.isDir()) // links to files and broken links; linked folders aren't followed
+                            {
+                                dir.size += fileSize(fiEntry, &dir.links);
+                                ++dir.files;
+                                dir.fileNames << entry.name;
+                            }
+                        }
+                        else if(entry.dir) dir.subdirs << entry.name;
+                        else
+                        {
+                            dir.size += entry.size;
+                            ++dir.files;
+                            dir.fileNames << entry.name;
+                        }
+                    }
+                }
+
+                for(const QString &subdir : dir.subdirs)
+                {
+                    if(mod.skips(task.rel.isEmpty() ? subdir : task.rel+"/"+subdir)) continue; // a cached listing may still hold it
+                    mod.pending.ref();
+                    push({ task.mod, task.path+"/"+subdir, task.rel.isEmpty() ? subdir : task.rel+"/"+subdir }, worker);
+                }
+
+                mod.size.fetchAndAddRelaxed(dir.size);
+                files = dir.files;
+                mod.fileCount.fetchAndAddRelaxed(files);
+                mod.links.fetchAndAddRelaxed(dir.links);
+
+                QMutexLocker lock(&mod.freshMutex);
+                mod.fresh.insert({ task.rel, std::move(dir) });
+            }
+        }
+
+        if(!mod.pending.deref())
+        {
+            if(!mod.cancelled.loadAcquire())
+            {
+                QStringList paths = std::move(mod.packed);
+                for(const std::pair<const QString, ModIndex::Dir> &dir : mod.fresh) // every folder: cached ones too
+                    for(const QString &name : dir.second.fileNames)
+                        paths << (dir.first.isEmpty() ? name : dir.first+"/"+name);
+                conflictIndex.setMod(mod.modName, paths);
+
+                if(!mod.fresh.empty()) index.store(mod.root, std::move(mod.fresh));
+                emit scanModUpdate(mod.modName, mod.size.loadAcquire(), mod.fileCount.loadAcquire(), // always exact
+                                   mod.links.loadAcquire());
+                emit scanModReady(mod.modName);
+            }
+        }
+        else if(!mod.cancelled.loadAcquire() && mod.progress.ready(files))
+            emit scanModUpdate(mod.modName, mod.size.loadAcquire(), mod.fileCount.loadAcquire(), mod.links.loadAcquire());
+    }
+
+/********************************************************************/
+/*      SCAN WORKER     *********************************************/
+/********************************************************************/
+    void ScanWorker::push(ScanEngine::Task &&task)
+    {
+        QMutexLocker lock(&mutex);
+        tasks.push_back(std::move(task));
+    }
+
+    bool ScanWorker::pop(ScanEngine::Task &task)
+    {
+        QMutexLocker lock(&mutex);
+        if(tasks.empty()) return false;
+
+        task = std::move(tasks.back());
+        tasks.pop_back();
+        return true;
+    }
+
+    bool ScanWorker::steal(ScanEngine::Task &task)
+    {
+        QMutexLocker lock(&mutex);
+        if(tasks.empty()) return false;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        return true;
+    }
+
+    void ScanWorker::run()
+    {
+        while(engine->waitForWork())
+        {
+            ScanEngine::Task task;
+            while(pop(task) || engine->steal(id, task))
+            {
+                engine->queued.deref();
+                engine->process(task, id);
+                task = ScanEngine::Task();
+            }
+        }
+    }
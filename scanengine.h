@@ -0,0 +1,105 @@
+#ifndef SCANENGINE_H
+#define SCANENGINE_H
+
+#include "_throttle.h"
+#include "threadbase.h"
+#include "modindex.h"
+#include "conflictindex.h"
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class ScanWorker;
+
+/* One pool of ScanWorkers (sized to the core count) shared by all mod scans.
+ * Every directory is its own task, so a single large mod is spread over all workers:
+ * a worker pushes subdirectories onto its own deque (LIFO) and idle workers steal from the front of the others.
+ * IndexedScan reuses the ModIndex entry of every folder whose mtime is unchanged instead of listing it.
+ * A completed scan replaces the mod's paths in the conflict index. */
+class ScanEngine : public ThreadBase
+{
+    Q_OBJECT
+
+public:        struct ModScan {
+                   const QString          modName, root;
+                   QAtomicInteger<qint64> size = 0;
+                   QAtomicInt             fileCount = 0,
+                                          pending = 1, // directory tasks not yet finished
+                                          cancelled = 0,
+                                          links = 0;   // files sized by following a link
+
+                   const std::shared_ptr<const ModIndex::Tree> cached; // nullptr: FullScan
+                   const QStringList skip; // paths under root that aren't walked
+                   ModIndex::Tree fresh;
+                   QStringList    packed; // what a packed mod lists
+                   QMutex         freshMutex;
+                   Throttle       progress;
+
+                   ModScan(const QString &modName, const QString &root, std::shared_ptr<const ModIndex::Tree> cached,
+                           const QStringList &skip)
+                       : modName(modName), root(root), cached(std::move(cached)), skip(skip) {}
+
+                   bool skips(const QString &rel) const
+                   { return !skip.isEmpty() && skip.contains(rel, Qt::CaseInsensitive); }
+               };
+               struct Task {
+                   std::shared_ptr<ModScan> mod;
+                   QString                  path, rel;
+               };
+
+private:       std::vector<std::unique_ptr<ScanWorker> > workers;
+               std::unordered_map<QString, std::shared_ptr<ModScan> > active; // GUI thread only
+
+               QMutex         idleMutex;
+               QWaitCondition idleWait;
+               QAtomicInt     queued = 0, stopping = 0, nextWorker = 0;
+
+               ModIndex      index;
+               ConflictIndex conflictIndex;
+               QTimer        saveTimer;
+
+public:        explicit ScanEngine(const QString &indexPath, QObject *parent=nullptr);
+               ~ScanEngine();
+
+               void scan(const QString &modName, const QString &path,
+                         const ThreadAction::ScanMode &mode=ThreadAction::FullScan, const QStringList &skip=QStringList());
+               void cancel(const QString &modName);
+               void cancelAll();
+               void moveIndex (const QString &root, const QString &newRoot) { index.move(root, newRoot); }
+               void pruneIndex(const QStringList &roots);
+               std::shared_ptr<const ModIndex::Tree> indexed(const QString &root) const { return index.tree(root); }
+               ConflictIndex &conflicts() { return conflictIndex; }
+
+private slots: void saveIndex() { index.save(); }
+
+private:       friend class ScanWorker;
+
+               void push(Task &&task, const int worker=-1);
+               bool steal(const int thief, Task &task);
+               bool waitForWork();
+               void process(const Task &task, const int worker);
+};
+
+class ScanWorker : public QThread
+{
+               ScanEngine *const engine;
+               const int         id;
+
+               std::deque<ScanEngine::Task> tasks;
+               QMutex                       mutex;
+
+public:        ScanWorker(ScanEngine *const engine, const int id) : QThread(), engine(engine), id(id) {}
+
+               void push(ScanEngine::Task &&task);
+               bool pop  (ScanEngine::Task &task);
+               bool steal(ScanEngine::Task &task);
+
+private:       void run() override;
+};
+
+#endif // SCANENGINE_H
@@ -0,0 +1,65 @@
+/* Checks MpqArchive against the archives of mpqfixture.h, once and untimed. Prints one line per check,
+ * "FAIL" lines on stderr, and exits with 1 if any check failed.
+ * Checks: pack (MpqWriter), open+size (fileCount and unpackedSize from the tables), entries (names from (listfile)).
+ *
+ * test_mpq [--files N] [--root PATH] [--keep] */
+#include "mpqfixture.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+
+#include <cstdio>
+
+static int failures = 0;
+
+static void report(const char *archive, const char *check, const bool ok)
+{
+    std::fprintf(ok ? stdout : stderr, "%s %s: %s\n", ok ? "PASS" : "FAIL", archive, check);
+    if(!ok) ++failures;
+}
+
+static void check(const char *archive, const QString &path, const Listing &listing)
+{
+    const MpqArchive mpq(path);
+    report(archive, "open+size", checkSize(mpq, listing));
+    report(archive, "entries",   checkEntries(mpq.entries(), listing));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOptions({
+        { "files", "Files in the packed archive.", "N", "2000" },
+        { "root",  "Work folder (default: system temp).", "PATH" },
+        { "keep",  "Don't delete the work folder." }
+    });
+    parser.process(a);
+
+    QTemporaryDir tmp(parser.isSet("root") ? parser.value("root")+"/wmmtest-XXXXXX" : QString());
+    tmp.setAutoRemove(!parser.isSet("keep"));
+    if(!tmp.isValid())
+    {
+        std::fprintf(stderr, "can't create work folder\n");
+        return 1;
+    }
+
+    Listing packedListing, fixtureListing;
+    const std::vector<MpqWriter::File> &files = generate(tmp.path()+"/src", std::max(parser.value("files").toInt(), 1),
+                                                         packedListing);
+    if(files.empty() || !fixture(tmp.path()+"/fixture.mpq", fixtureListing))
+    {
+        std::fprintf(stderr, "couldn't write the source files\n");
+        return 1;
+    }
+
+    const QString &packed = tmp.path()+"/packed.mpq";
+    report("packed", "pack", MpqWriter::pack(packed, files) == MpqWriter::Packed);
+    check("packed",  packed,                    packedListing);
+    check("fixture", tmp.path()+"/fixture.mpq", fixtureListing);
+
+    return failures ? 1 : 0;
+}
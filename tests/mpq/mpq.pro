@@ -0,0 +1,20 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console testcase
+CONFIG   -= app_bundle
+
+TARGET = test_mpq
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    mpqfixture.cpp \
+    ../../mpqarchive.cpp \
+    ../../mpqwriter.cpp
+
+HEADERS += \
+    mpqfixture.h \
+    ../../mpqarchive.h \
+    ../../mpqwriter.h
@@ -0,0 +1,204 @@
+#include "mpqfixture.h"
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <random>
+
+/********************************************************************/
+/*      CHECKS      *************************************************/
+/********************************************************************/
+bool checkSize(const MpqArchive &mpq, const Listing &listing)
+{
+    qint64 bytes = 0;
+    for(const std::pair<const QString, qint64> &file : listing) bytes += file.second;
+    return mpq.isOpen() && mpq.fileCount() == int(listing.size()) && mpq.unpackedSize() == bytes;
+}
+
+bool checkEntries(const std::vector<MpqArchive::Entry> &entries, const Listing &listing)
+{
+    Listing listed;
+    for(const MpqArchive::Entry &entry : entries) listed[entry.name] = entry.size;
+    return entries.size() == listing.size() && listed == listing;
+}
+
+/********************************************************************/
+/*      PACKED      *************************************************/
+/********************************************************************/
+std::vector<MpqWriter::File> generate(const QString &root, const int count, Listing &listing)
+{
+    static const char *const dirs[] = { "Units", "Abilities\\Spells", "Textures", "UI\\Widgets\\Console" };
+    std::mt19937 rng(42);
+    std::vector<MpqWriter::File> files;
+
+    for(int i=0; i < count; ++i)
+    {
+        MpqWriter::File file;
+        file.name = QString("%0\\File%1.%2").arg(dirs[i % 4]).arg(i).arg(i % 2 ? "txt" : "blp");
+        file.path = root+"/"+QString(file.name).replace('\\', '/');
+
+        QByteArray content;
+        const int size = int(rng() % 20000); // empty, single-sector and multi-sector files
+        if(i % 2)
+        {
+            while(content.size() < size) content += QByteArray::number(i)+" = some text that compresses\r\n";
+            content.truncate(size);
+        }
+        else
+        {
+            content.resize(size);
+            for(char &ch : content) ch = char(rng()); // doesn't compress: stored as is
+        }
+
+        QDir().mkpath(QFileInfo(file.path).absolutePath());
+        QFile out(file.path);
+        if(!out.open(QIODevice::WriteOnly) || out.write(content) != content.size()) return {};
+
+        file.size = content.size();
+        listing[file.name] = file.size;
+        files.push_back(std::move(file));
+    }
+    return files;
+}
+
+/********************************************************************/
+/*      FIXTURE     *************************************************/
+/********************************************************************/
+namespace fx { // the format as documented, independent of MpqArchive's own code
+static std::vector<quint32> cryptTable()
+{
+    std::vector<quint32> table(0x500);
+    quint32 seed = 0x00100001;
+    for(quint32 i=0; i < 0x100; ++i)
+        for(quint32 j=i, k=0; k < 5; ++k, j += 0x100)
+        {
+            seed = (seed*125+3) % 0x2AAAAB;
+            const quint32 high = (seed & 0xFFFF) << 16;
+            seed = (seed*125+3) % 0x2AAAAB;
+            table[j] = high | (seed & 0xFFFF);
+        }
+    return table;
+}
+static const std::vector<quint32> table = cryptTable();
+
+static quint32 hash(const QByteArray &name, const quint32 type)
+{
+    quint32 seed1 = 0x7FED7FED, seed2 = 0xEEEEEEEE;
+    for(uchar ch : name)
+    {
+        if(ch >= 'a' && ch <= 'z') ch -= 'a'-'A';
+        seed1 = table[type*0x100+ch] ^ (seed1+seed2);
+        seed2 = ch + seed1 + seed2 + (seed2 << 5) + 3;
+    }
+    return seed1;
+}
+
+static void encrypt(char *data, const int size, quint32 key) // whole dwords only, as the game does
+{
+    quint32 seed = 0xEEEEEEEE;
+    for(int i=0; i+4 <= size; i += 4)
+    {
+        seed += table[0x400+(key & 0xFF)];
+        const quint32 plain = qFromLittleEndian<quint32>(data+i);
+        qToLittleEndian<quint32>(plain ^ (key+seed), data+i);
+        key  = ((~key << 0x15) + 0x11111111) | (key >> 0x0B);
+        seed = plain + seed + (seed << 5) + 3;
+    }
+}
+
+static void put32(QByteArray &out, const quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+}
+
+bool fixture(const QString &path, Listing &listing)
+{
+    const qint64 PAD = 512; // the header is found at the next multiple of 512
+    const quint32 SECTOR = 4096,
+                  COMPRESS = 0x200, ENCRYPTED = 0x10000, FIX_KEY = 0x20000, EXISTS = 0x80000000;
+
+    struct File { QByteArray name, stored; quint32 size, flags; };
+    std::vector<File> files(3);
+
+    // Units\Fix.txt: two sectors, encrypted with the key adjusted by offset and size
+    QByteArray fix;
+    while(fix.size() < 5001) fix += "fix-key encrypted sector data ";
+    fix.truncate(5001);
+    files[0] = { "Units\\Fix.txt", fix, quint32(fix.size()), EXISTS|ENCRYPTED|FIX_KEY };
+
+    QByteArray plain(100, 'p');
+    files[1] = { "Readme.txt", plain, quint32(plain.size()), EXISTS };
+
+    // (listfile): one zlib sector behind its offset table; absent names are listed too, and must be ignored
+    QByteArray listfile = "Units\\Fix.txt\r\nReadme.txt\r\n";
+    for(int i=0; i < 40; ++i) listfile += "Units\\Missing"+QByteArray::number(i)+".txt\r\n";
+    const QByteArray &sector = QByteArray(1, '\x02')+qCompress(listfile).mid(4); // zlib: type byte, no length
+    QByteArray stored;
+    fx::put32(stored, 8);
+    fx::put32(stored, quint32(8+sector.size()));
+    stored += sector;
+    files[2] = { "(listfile)", stored, quint32(listfile.size()), EXISTS|COMPRESS };
+
+    // Data, then the hash table (4 slots) and the block table, offsets from the header
+    QByteArray body;
+    std::vector<quint32> offsets;
+    for(File &file : files)
+    {
+        const quint32 offset = quint32(32+body.size());
+        offsets.push_back(offset);
+        if(file.flags & ENCRYPTED)
+        {
+            const QByteArray &base = file.name.mid(file.name.lastIndexOf('\\')+1);
+            const quint32 key = (fx::hash(base, 3)+offset) ^ file.size;
+            for(quint32 i=0; i*SECTOR < quint32(file.stored.size()); ++i)
+                fx::encrypt(file.stored.data()+i*SECTOR, int(std::min(SECTOR, quint32(file.stored.size())-i*SECTOR)), key+i);
+        }
+        body += file.stored;
+    }
+
+    std::vector<quint32> hashes(4*4, 0xFFFFFFFF);
+    for(size_t i=0; i < files.size(); ++i)
+    {
+        quint32 slot = fx::hash(files[i].name, 0) % 4;
+        while(hashes[slot*4+3] != 0xFFFFFFFF) slot = (slot+1) % 4;
+        hashes[slot*4]   = fx::hash(files[i].name, 1);
+        hashes[slot*4+1] = fx::hash(files[i].name, 2);
+        hashes[slot*4+2] = 0; // locale, platform
+        hashes[slot*4+3] = quint32(i);
+    }
+    QByteArray hashTable, blockTable;
+    for(const quint32 value : hashes) fx::put32(hashTable, value);
+    for(size_t i=0; i < files.size(); ++i)
+    {
+        fx::put32(blockTable, offsets[i]);
+        fx::put32(blockTable, quint32(files[i].stored.size()));
+        fx::put32(blockTable, files[i].size);
+        fx::put32(blockTable, files[i].flags);
+    }
+    fx::encrypt(hashTable.data(),  hashTable.size(),  fx::hash("(hash table)", 3));
+    fx::encrypt(blockTable.data(), blockTable.size(), fx::hash("(block table)", 3));
+
+    const quint32 hashPos = quint32(32+body.size()), blockPos = quint32(hashPos+hashTable.size());
+    QByteArray header;
+    fx::put32(header, 0x1A51504D);
+    fx::put32(header, 32);
+    fx::put32(header, quint32(blockPos+blockTable.size()));
+    fx::put32(header, 3u << 16); // format 0, 512 << 3 sectors
+    fx::put32(header, hashPos);
+    fx::put32(header, blockPos);
+    fx::put32(header, 4);
+    fx::put32(header, quint32(files.size()));
+
+    QFile out(path);
+    const QByteArray &archive = QByteArray(int(PAD), '\0')+header+body+hashTable+blockTable;
+    if(!out.open(QIODevice::WriteOnly) || out.write(archive) != archive.size()) return false;
+
+    listing[files[0].name] = files[0].size;
+    listing[files[1].name] = files[1].size;
+    return true;
+}
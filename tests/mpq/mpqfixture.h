@@ -0,0 +1,22 @@
+#ifndef MPQFIXTURE_H
+#define MPQFIXTURE_H
+
+#include "mpqarchive.h"
+#include "mpqwriter.h"
+
+#include <map>
+#include <vector>
+
+/* Archives made here to check MpqArchive against, shared by test_mpq and bench_mpq:
+ *   packed:  files (text and random bytes, in subfolders) for MpqWriter, so (listfile) is zlib
+ *   fixture: built byte by byte with its own crypt code, behind 512 bytes of padding: a file encrypted with
+ *            the fix key over two sectors, a plain one, and a zlib (listfile) that also lists absent names */
+typedef std::map<QString, qint64> Listing; // name -> size, what the archive should hold
+
+std::vector<MpqWriter::File> generate(const QString &root, const int count, Listing &listing); // empty: not written
+bool fixture(const QString &path, Listing &listing);
+
+bool checkSize   (const MpqArchive &mpq, const Listing &listing);                      // fileCount and unpackedSize
+bool checkEntries(const std::vector<MpqArchive::Entry> &entries, const Listing &listing); // names from (listfile)
+
+#endif // MPQFIXTURE_H
@@ -0,0 +1,10 @@
+#-------------------------------------------------
+#
+# Tests: console apps that exit with 1 on a failed check, not part of the release build.
+# Run from a Qt command prompt: qmake tests.pro && make && make check
+#
+#-------------------------------------------------
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    mpq
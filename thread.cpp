@@ -8,6 +8,17 @@
 #include "_msgr.h"
 #include "thread.h"
 #include "thread_pvt.h"
+#include "dirlister.h"
+#include "copyengine.h"
+#include "reaper.h"
+#include "backupmanifest.h"
+#include "overlay.h"
+#include "modstore.h"
+#include "modmanifest.h"
+#include "hashengine.h"
+#include "mpqarchive.h"
+#include "mpqwriter.h"
+#include "conflictindex.h"
 
 #include <QVBoxLayout>
 #include <QLabel>
@@ -16,6 +27,10 @@
 #include <QPushButton>
 #include <QMessageBox>
 #include <QDirIterator>
+#include <QDateTime>
+#include <QStorageInfo>
+#include <QThreadPool>
+#include <QSet>
 #include <QProcess>
 #include <QApplication>
 #include <QStringList>
@@ -32,14 +47,110 @@
 /*      THREADACTION        *****************************************/
 /********************************************************************/
     ThreadAction::ThreadAction(const Action &action, const QString &modName)
-        : PROCESSING(action == Mount     ? d::MOUNTING
-                     : action == Unmount ? d::UNMOUNTING
-                     : action == Add     ? d::ADDING
-                     : action == Delete  ? d::DELETING
-                                         : d::PROCESSING),
-
+        : PROCESSING(d::ac[action][size_t(d::Ac::PROCESSING)]),
           modName(modName), action(action) {}
 
+/********************************************************************/
+/*      THREADBASE      *********************************************/
+/********************************************************************/
+    QString ThreadBase::getMB(const qint64 size)
+    {
+        if(size > 0)
+        {
+            double sizeMB = double(size)/1024/1024;
+            if(sizeMB < 0.01) return d::ALMOST_ZERO_MB;
+            else
+            {
+                QString qsModSize = QString::number(round(sizeMB*100)/100);
+                if(qsModSize.lastIndexOf('.') == qsModSize.length()-2) qsModSize += "0";
+                else if(qsModSize.lastIndexOf('.') == -1) qsModSize += ".00";
+                return d::X_MB.arg(qsModSize);
+            }
+        }
+        else return d::ZERO_MB;
+    }
+
+    qint64 ThreadBase::fileSize(const QFileInfo &fi, int *links)
+    {
+        if(!fi.isSymLink()) return fi.size();
+
+        if(links) ++*links;
+
+        // Follow the chain link by link (metadata only): broken links and cycles count as 0 bytes
+        QFileInfo target(fi);
+        QSet<QString> visited;
+        while(target.isSymLink())
+        {
+            const QString &path = target.absoluteFilePath();
+            if(visited.contains(path) || visited.size() >= MAX_LINK_HOPS) return 0;
+            visited.insert(path);
+
+            const QString &next = target.symLinkTarget();
+            if(next.isEmpty()) return 0;
+            target = QFileInfo(next);
+        }
+
+        return target.exists() && !target.isDir() ? target.size() : 0;
+    }
+
+    quint64 ThreadBase::fileId(const QString &path)
+    {
+        const HANDLE handle = CreateFileW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(path).utf16()), 0,
+                                          FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, nullptr,
+                                          OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr); // folders need BACKUP_SEMANTICS
+        if(handle == INVALID_HANDLE_VALUE) return 0;
+
+        BY_HANDLE_FILE_INFORMATION info;
+        const bool ok = GetFileInformationByHandle(handle, &info);
+        CloseHandle(handle);
+
+        return ok ? quint64(info.nFileIndexHigh) << 32 | info.nFileIndexLow : 0;
+    }
+
+/********************************************************************/
+/*      UNLINKER        *********************************************/
+/********************************************************************/
+    void Unlinker::push(const QString &path)
+    {
+        QMutexLocker lock(&mutex);
+        paths << path;
+        queued.wakeOne();
+    }
+
+    QStringList Unlinker::finish()
+    {
+        mutex.lock();
+        closed = true;
+        queued.wakeOne();
+        mutex.unlock();
+
+        wait();
+        return failed;
+    }
+
+    void Unlinker::run()
+    {
+        setPriority(QThread::LowPriority);
+
+        QMutexLocker lock(&mutex);
+        forever
+        {
+            if(paths.isEmpty())
+            {
+                if(closed) break;
+                queued.wait(&mutex);
+                continue;
+            }
+
+            const QString path = paths.takeFirst();
+            lock.unlock();
+            const bool removed = QFile::remove(path);
+            lock.relock();
+
+            if(!removed) failed << path;
+        }
+    }
+
 /********************************************************************/
 /*      FILESTATUS DIALOG       *************************************/
 /********************************************************************/
@@ -169,7 +280,7 @@
     const QString ThreadWorker::extBackup = QStringLiteral(u".wmmbackup");
 
     void ThreadWorker::init(const qint64 index, const QString &data1, const QString &data2,
-                            const QString &args, const md::modData &modData)
+                            const QString &args, const md::Registry &registry)
     {
 
         switch(action.action)
@@ -178,50 +289,90 @@
         case ThreadAction::ModData:
         {
             bool mountedFound = data1.isEmpty();
-            md::modData newData;
-            QStringList modNames;
+            std::vector<md::Diff::Entry> listing;
+            listing.reserve(size_t(registry.count())+1);
 
-            int i=0;
-            for(QDirIterator itMods(pathMods, QDir::NoDotAndDotDot|QDir::Dirs|QDir::NoSymLinks);
-                itMods.hasNext(); ++i)
+            for(QDirIterator itMods(pathMods, QDir::NoDotAndDotDot|QDir::Dirs|QDir::Files|QDir::NoSymLinks); itMods.hasNext(); )
             {
                 itMods.next();
-                const QString &modName = itMods.fileName();
+                if(itMods.fileName() == Reaper::TRASH || itMods.fileName() == ModStore::DIR || itMods.fileName() == LayerStack::DIR
+                   || (!itMods.fileInfo().isDir() && !MpqArchive::isPacked(itMods.fileName()))) continue;
+
+                md::Diff::Entry entry;
+                entry.name = itMods.fileName();
+                entry.stamp.mtime = itMods.fileInfo().lastModified().toMSecsSinceEpoch();
                 
-                if(!mountedFound && data1 == modName) mountedFound = true;
+                if(!mountedFound && data1 == entry.name) mountedFound = true;
 
-                modNames << modName;
-                newData.insert({ modName, md::newData(i, md::exists(modData, modName) ? md::busy(modData.at(modName)) : false ) });
+                listing.push_back(std::move(entry));
             }
             
-            if(!mountedFound)
+            if(!mountedFound) // external mod: listed first, no stamp
             {
-                modNames.insert(0, data1);
-                newData.insert({ data1, md::newData(0, false) });
-                for(int i=1; i < modNames.length(); ++i) // Renumber mods following added
-                    md::setRow(newData[modNames[i]], i);
+                md::Diff::Entry entry;
+                entry.name = data1;
+                listing.insert(listing.begin(), std::move(entry));
             }
 
-            emit modDataReady(newData, modNames);
+            md::Diff diff;
+            std::vector<md::Diff::Entry *> unknown;
+            std::unordered_map<QString, int> listed;
+            listed.reserve(listing.size());
 
-            break;
-        }
+            for(size_t i=0; i < listing.size(); ++i)
+            {
+                md::Diff::Entry &entry = listing[i];
+                entry.row = int(i);
+                listed.insert({ entry.name, entry.row });
+
+                const int row = registry.row(entry.name);
+                if(row < 0)
+                {
+                    if(entry.name != data1 || mountedFound) entry.stamp.id = fileId(pathMods+"/"+entry.name);
+                    unknown.push_back(&entry);
+                }
+                else if(entry.name == data1 || entry.stamp.mtime != registry.stamp(row).mtime)
+                {
+                    entry.stamp.id = registry.stamp(row).id;
+                    diff.changed.push_back(entry); // the mounted mod is always rescanned
+                }
+                else ++diff.unchanged;
+            }
+
+            // Mods no longer listed: a new name with the same file id is a rename, not a new mod
+            std::unordered_map<quint64, QString> lost;
+            for(int row=0; row < registry.count(); ++row)
+            {
+                const QString &modName = registry.name(row);
+                if(listed.find(modName) == listed.end())
+                {
+                    if(registry.stamp(row).id) lost.insert({ registry.stamp(row).id, modName });
+                    else diff.removed << modName;
+                }
+            }
+
+            for(md::Diff::Entry *entry : unknown)
+            {
+                const auto itLost = entry->stamp.id ? lost.find(entry->stamp.id) : lost.end();
+                if(itLost == lost.end()) diff.added.push_back(*entry);
+                else
+                {
+                    diff.renamed.push_back({ itLost->second, *entry });
+                    lost.erase(itLost);
+                }
+            }
+            for(const std::pair<const quint64, QString> &modName : lost) diff.removed << modName.second;
+
+            emit modDataReady(diff);
 
-    // SCAN
-        case ThreadAction::Scan:
-            scanPath(pathMods+"/"+action.modName);
-            emit scanModReady(action.modName);
-            break;
-            
-    // SCAN EXTERNAL (data1 -> modPath)
-       case ThreadAction::ScanEx:
-            scanPath(data1);
-            emit scanModReady(action.modName);
             break;
+        }
 
-    // MOUNT
+    // MOUNT (index -> overlay, data1 -> layers '/'-separated, bottom first)
         case ThreadAction::Mount:
-            action.add(processFile(pathMods+"/"+action.modName, pathGame+"/"+md::w3mod, Link));
+            if(!data1.isEmpty()) mountLayers(data1.split('/', QString::SkipEmptyParts));
+            else if(index) mountOverlay();
+            else action.add(processFile(pathMods+"/"+action.modName, pathGame+"/"+md::w3mod, Link));
             emit resultReady(action);
             break;
 
@@ -230,8 +381,15 @@
         {
             const QString &modPath = pathGame+"/"+md::w3mod;
             const QFileInfo &fiMounted(modPath);
-            
-            if(!fiMounted.isSymLink() && !fiMounted.exists())
+            Overlay overlay;
+
+            if(overlay.load())
+            {
+                if(action.modName != overlay.modName)
+                    emit progressUpdate(d::X_NOT_MOUNTED__X.arg(action.modName, d::UNMOUNTING_X___.arg(overlay.modName)), true);
+                unmountOverlay(overlay);
+            }
+            else if(!fiMounted.isSymLink() && !fiMounted.exists())
                 emit progressUpdate(d::X_NOT_MOUNTED__X.arg(action.modName, d::NOTHING_UNMOUNT_), true);
             else if(fiMounted.isSymLink())
             {
@@ -241,8 +399,12 @@
                 if(action.modName != fiTarget.fileName())
                     emit progressUpdate(d::X_NOT_MOUNTED__X.arg(action.modName, d::UNMOUNTING_X___.arg(fiTarget.fileName())), true);
 
-                if(fiTarget.absolutePath() == pathMods || (fiNew.isSymLink() && fiNew.symLinkTarget() == fiTarget.absoluteFilePath()))
+                if(fiTarget.absolutePath() == pathMods || fiTarget.absolutePath() == pathMods+"/"+LayerStack::DIR // the farm stays
+                   || (fiNew.isSymLink() && fiNew.symLinkTarget() == fiTarget.absoluteFilePath()))
+                {
                     action.add(processFile(modPath, pathGame, Delete));
+                    pruneTouched();
+                }
                 else action.add(backup(modPath, false, pathGame+"/"+md::w3modX.arg(fiTarget.fileName()+"%0")) ? ThreadAction::Success
                                                                                                               : ThreadAction::Failed);
             }
@@ -263,40 +425,80 @@
         case ThreadAction::Add:
         {
             bool created = false;
-            for(QDirIterator srcItr(data1, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories);
-                !action.aborted() && srcItr.hasNext();
-                checkState())
+            const bool sameVolume = QStorageInfo(data1).rootPath() == QStorageInfo(pathMods).rootPath();
+
+            if(!index && sameVolume && moveTree(data1, data2)) // MOVE, same volume: one rename for the whole folder
             {
-                srcItr.next();
-                const QString relativePath = srcItr.filePath().remove(data1+"/"),
-                              itrDst = data2+"/"+relativePath;
+                emit progressUpdate(action.modName);
 
-                emit progressUpdate(relativePath);
+                created = true;
+                emit modAdded(action.modName, modRow());
+                QThread::msleep(10); // make sure signal arrives first
 
-                ThreadAction::Result result = processFile(srcItr.filePath(), itrDst, index ? Mode::Copy : Mode::Move);
-                action.add(result);
+                scanPath(data2);
+                action.add(ThreadAction::Success, fileCount);
+            }
+            else
+            {
+                Unlinker unlinker; // MOVE, other volume: copy, and unlink the source on the side
+                const bool pipeline = !index && !sameVolume;
+                if(pipeline) unlinker.start();
 
-                if(result == ThreadAction::Success)
+                for(QDirIterator srcItr(data1, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories);
+                    !action.aborted() && srcItr.hasNext();
+                    checkState())
                 {
-                    if(!created)
+                    srcItr.next();
+                    const QString relativePath = srcItr.filePath().remove(data1+"/"),
+                                  itrDst = data2+"/"+relativePath;
+
+                    emit progressUpdate(relativePath);
+
+                    ThreadAction::Result result = processFile(srcItr.filePath(), itrDst,
+                                                              index || pipeline ? Mode::Copy : Mode::Move);
+                    action.add(result);
+
+                    if(result == ThreadAction::Success)
                     {
-                        int row=-1;
-                        for(QDirIterator itMods(pathMods, QDir::NoDotAndDotDot|QDir::Dirs|QDir::NoSymLinks);
-                            itMods.hasNext() && QDir(itMods.filePath()).dirName() != action.modName;
-                            ++row) itMods.next();
+                        if(pipeline) unlinker.push(srcItr.filePath());
 
-                        if(row != -1)
+                        if(!created)
                         {
-                            created = true;
-                            emit modAdded(action.modName, row);
-                            QThread::msleep(10); // make sure signal arrives first
+                            const int row = modRow();
+                            if(row != -1)
+                            {
+                                created = true;
+                                emit modAdded(action.modName, row);
+                                QThread::msleep(10); // make sure signal arrives first
+                            }
                         }
+
+                        if(created) scanFile(itrDst);
                     }
+                }
 
-                    if(created) scanFile(itrDst);
+                if(pipeline)
+                {
+                    for(const QString &path : unlinker.finish())
+                        emit progressUpdate(d::FAILED_TO_X.arg(d::lDELETE+" "+d::lFILEc_X.arg(path)), true);
+
+                    // drop the emptied source folders, deepest first; rmdir() leaves anything not moved
+                    QStringList dirs;
+                    for(QDirIterator itDir(data1, QDir::NoDotAndDotDot|QDir::Dirs|QDir::Hidden|QDir::System, QDirIterator::Subdirectories);
+                        itDir.hasNext(); ) dirs << itDir.next();
+                    for(int i=dirs.length()-1; i >= 0; --i) QDir().rmdir(dirs[i]);
+                    QDir().rmdir(data1);
                 }
             }
 
+            pruneTouched();
+            if(created) emit scanModUpdate(action.modName, modSize, fileCount, linkCount);
+            if(created && !action.aborted() && ModStore::dedupOnAdd())
+            {
+                emit statusUpdate(d::DEDUPLICATING);
+                dedupMod(action.modName, false);
+                ModStore::shared().save();
+            }
             emit resultReady(action);
 
             break;
@@ -306,36 +508,90 @@
         case ThreadAction::Delete:
         {
             if(index > 0) modSize = index;
-            if(!data1.isEmpty()) getFileCount(data1);
+            if(!data1.isEmpty()) fileCount = data1.toInt();
 
             const QString &pathMod = pathMods+"/"+action.modName;
 
-            for(QDirIterator itMod(pathMod, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System,  QDirIterator::Subdirectories);
-                !action.aborted() && itMod.hasNext(); checkState())
+            if(!Reaper::bury(pathMods, action.modName).isEmpty()) // One rename; Reaper removes the files later
+            {
+                emit progressUpdate(action.modName);
+                action.add(ThreadAction::Success, std::max(fileCount, 1));
+                modSize = fileCount = 0;
+
+                ModStore &store = ModStore::shared(); // objects only this mod used go with it
+                store.dropMod(action.modName);
+                store.save();
+                ModManifest::remove(action.modName);
+            }
+            else for(QDirIterator itMod(pathMod, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System,  QDirIterator::Subdirectories);
+                     !action.aborted() && itMod.hasNext(); checkState()) // Something is in use: delete what can be
             {
                 itMod.next();
                 const QString &filePath = itMod.filePath();
 
                 emit progressUpdate(filePath);
 
-                scanFile(filePath, true, true); // Silently remove file from data
-
+                const qint64 size = fileSize(itMod.fileInfo());
                 ThreadAction::Result result = processFile(filePath, pathMods, ThreadWorker::Delete);
                 action.add(result);
 
-                if(result != ThreadAction::Success && (itMod.fileInfo().isSymLink() || itMod.fileInfo().exists()))
-                    scanFile(filePath, false, true); // Silently add file back to data if it still exists
+                if(result == ThreadAction::Success) scanSize(size, true, true); // Silently remove file from data
 
-                emit scanModUpdate(action.modName, getMB(), d::X_FILES.arg(fileCount), modSize); // Data is up to date
+                if(progress.ready()) emit scanModUpdate(action.modName, modSize, fileCount); // Data is up to date
             }
 
+            pruneTouched();
             if(!QFileInfo().exists(pathMod)) emit modDeleted(action.modName);
+            else emit scanModUpdate(action.modName, modSize, fileCount);
 
             emit resultReady(action);
 
             break;
         }
 
+     // DEDUP (data1 -> mod names, '/'-separated)
+        case ThreadAction::Dedup:
+        {
+            ModStore &store = ModStore::shared();
+
+            for(const QString &modName : data1.split('/', QString::SkipEmptyParts))
+            {
+                if(action.aborted()) break;
+                emit statusUpdate(modName);
+                dedupMod(modName);
+            }
+
+            const int swept = store.sweep();
+            if(swept) emit progressUpdate(d::X_UNUSED_OBJECTS_DELETED_.arg(swept));
+            if(!store.save()) emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(ModStore::DIR+"/store.idx"))), true);
+
+            emit resultReady(action);
+
+            break;
+        }
+
+     // VERIFY (index, data1 -> (bool)accept, mod names '/'-separated)
+        case ThreadAction::Verify:
+            for(const QString &modName : data1.split('/', QString::SkipEmptyParts))
+            {
+                if(action.aborted()) break;
+                emit statusUpdate(modName);
+                verifyMod(modName, index);
+            }
+            emit resultReady(action);
+            break;
+
+     // PACK (data1 -> mod names '/'-separated)
+        case ThreadAction::Pack:
+            for(const QString &modName : data1.split('/', QString::SkipEmptyParts))
+            {
+                if(action.aborted()) break;
+                emit statusUpdate(modName);
+                packMod(modName);
+            }
+            emit resultReady(action);
+            break;
+
      // SHORTCUT (index, data1, data2, args -> iconIndex, dst, iconPath, args)
         case ThreadAction::Shortcut:
         {
@@ -366,126 +622,11 @@
         }
 
      // (no action)
-        case ThreadAction::NoAction:;
+        case ThreadAction::NoAction:
+        case ThreadAction::Action_Size:;
         }
 
-        /********************************************************************/
-        /*      OBSOLETE - may be useful later      *************************/
-        /********************************************************************
-
-            case ThreadAction::ScanMounted:
-            {
-                std::ifstream txtReader(pathOutFiles);
-                for(std::string line; std::getline(txtReader, line); ) if(line != "")
-                {
-                    QFileInfo fi(QString::fromStdString(line));
-                    if(fi.isSymLink() && fi.exists())
-                    {
-                        const QString &linkTrgt = fi.symLinkTarget();
-                        fi = QFileInfo(linkTrgt);
-                        if(fi.isSymLink() || fi.exists()) scanPath(linkTrgt);
-                    }
-                }
-
-                emit scanModReady(action.modName);
-
-                break;
-            }
-
-            case ThreadAction::Mount:
-            {
-                mountModIterator();
-
-                if(outFilesIt.is_open()) outFilesIt.close();
-                if(backupFilesIt.is_open()) backupFilesIt.close();
-
-                emit resultReady(action);
-
-                break;
-            }
-
-            case ThreadAction::Unmount:
-            {
-                if(index > 0) modSize = index;
-                if(!data1.isEmpty()) getFileCount(data1);
-
-                std::string newOutFiles = "";
-                std::ifstream txtReader(pathOutFiles);
-                for(std::string line; std::getline(txtReader, line); checkState()) if(line != "")
-                {
-                    if(!action.aborted())
-                    {
-                        const QString &qsLine = QString::fromStdString(line);
-                        const QFileInfo &fiLine(qsLine);
-                        const QString &targetPath = fiLine.symLinkTarget(); // Must be defined before calling deleteFile(qsLine)
-
-                        emit progressUpdate(qsLine);
-
-                        ThreadAction::Result resultIt = ThreadAction::Failed;
-                        if(fiLine.isSymLink()) resultIt = processFile(qsLine, QString(), ThreadWorker::Delete);
-                        else if(!fiLine.exists())
-                        {
-                            resultIt = ThreadAction::Missing;
-                            emit progressUpdate(d::MISSING_FILE_X.arg(qsLine), true);
-                        }
-                        else emit progressUpdate(d::NOT_A_SYMLINKc_X.arg(qsLine), true);
-
-                        if(resultIt == ThreadAction::Success)
-                        {
-                            const int beforeCount = fileCount;
-                            scanPath(targetPath, true);
-                            action.add(resultIt, beforeCount-fileCount);
-                        }
-                        else
-                        {
-                            action.add(resultIt);
-                            if(!action.forced()) newOutFiles += line+"\n";
-                        }
-                    }
-                    else newOutFiles += line+"\n";
-                }
-                txtReader.close();
-
-                std::ofstream txtWriter(pathOutFiles);
-                txtWriter << newOutFiles;
-                txtWriter.close();
-
-                if(!action.aborted())
-                {
-                    emit statusUpdate(d::lRESTORING_BACKUPS___);
-
-                    std::string newBackupFiles = "";
-                    txtReader.open(pathBackupFiles);
-                    for(std::string line; std::getline(txtReader, line); checkState()) if(line != "")
-                    {
-                        if(!action.aborted())
-                        {
-                            const QString &qsLine = QString::fromStdString(line);
-                            QString dst = qsLine;
-                            dst.truncate(dst.lastIndexOf(extBackup));
-
-                            emit progressUpdate(QFileInfo(qsLine).fileName());
-
-                            if(processFile(qsLine, dst) != ThreadAction::Success && !action.forced()) newBackupFiles += line+"\n";
-                        }
-                        else newBackupFiles += line+"\n";
-                    }
-                    txtReader.close();
-
-                    txtWriter.open(pathBackupFiles);
-                    txtWriter << newBackupFiles;
-                    txtWriter.close();
-
-                    emit statusUpdate(QString());
-                }
-
-                emit resultReady(action);
-
-                break;
-            }
-         ********************************************************************/
-        /********************************************************************/
-        /********************************************************************/
+        if(backups) BackupManifest::shared().save();
     }
 
     /* OBSOLETE *
@@ -499,6 +640,30 @@
     }
     **/
 
+    int ThreadWorker::modRow() const
+    {
+        int row=-1;
+        for(QDirIterator itMods(pathMods, QDir::NoDotAndDotDot|QDir::Dirs|QDir::Files|QDir::NoSymLinks);
+            itMods.hasNext() && QDir(itMods.filePath()).dirName() != action.modName; )
+        {
+            itMods.next();
+            if(itMods.fileName() != Reaper::TRASH && itMods.fileName() != ModStore::DIR // not listed as mods
+               && itMods.fileName() != LayerStack::DIR
+               && (itMods.fileInfo().isDir() || MpqArchive::isPacked(itMods.fileName()))) ++row;
+        }
+
+        return row;
+    }
+
+    bool ThreadWorker::moveTree(const QString &src, const QString &dst)
+    {   // same volume only: MoveFileEx without COPY_ALLOWED is a single atomic rename, never a copy
+        const QFileInfo &fiSrc(src);
+        if(fiSrc.isSymLink() || !fiSrc.isDir() || QFileInfo(dst).isSymLink() || QFileInfo().exists(dst)) return false;
+
+        return MoveFileExW(QDir::toNativeSeparators(src).toStdWString().c_str(),
+                           QDir::toNativeSeparators(dst).toStdWString().c_str(), 0);
+    }
+
     void ThreadWorker::checkState()
     {
         if(mutex)
@@ -513,60 +678,15 @@
         }
     }
 
-    QString ThreadWorker::getMB()
-    {
-        if(modSize > 0)
-        {
-            double sizeMB = double(modSize)/1024/1024;
-            if(sizeMB < 0.01) return d::ALMOST_ZERO_MB;
-            else
-            {
-                QString qsModSize = QString::number(round(sizeMB*100)/100);
-                if(qsModSize.lastIndexOf('.') == qsModSize.length()-2) qsModSize += "0";
-                else if(qsModSize.lastIndexOf('.') == -1) qsModSize += ".00";
-                return d::X_MB.arg(qsModSize);
-            }
-        }
-        else return d::ZERO_MB;
-    }
-
-    void ThreadWorker::getFileCount(QString qsFileCount)
-    {
-        qsFileCount.truncate(qsFileCount.lastIndexOf(d::X_FILES.arg(QString())));
-        fileCount = qsFileCount.toInt();
-    }
-
     qint64 ThreadWorker::scanFile(const QFileInfo &fi, const bool subtract, const bool silent)
-    {
-        qint64 size = 0;
-        if(fi.isSymLink() && fi.size() == QFileInfo(fi.symLinkTarget()).size())
-        {
-            const QString &filePath = fi.filePath();
-
-            QFile file(filePath);
-            if(file.exists() && file.open(QIODevice::ReadOnly))
-                size = file.size();
-            file.close();
-
-            if(size == 0)
-            {
-                QString tmpPath = filePath+".wmmTmp";
-                for(int i=2; QFileInfo().exists(tmpPath); ++i)
-                    tmpPath = filePath+".wmmTmp"+QString::number(i);
-
-                if(processFile(filePath, tmpPath, Mode::Copy) == ThreadAction::Success)
-                {
-                    size = QFileInfo(tmpPath).size();
-                    processFile(tmpPath, QString(), ThreadWorker::Delete);
-                }
-            }
-        }
-        else size = fi.size();
+    { return scanSize(fileSize(fi, &linkCount), subtract, silent); }
 
+    qint64 ThreadWorker::scanSize(const qint64 size, const bool subtract, const bool silent)
+    {
         modSize += (subtract ? -1 : 1) * size;
         fileCount += subtract ? -1 : 1;
 
-        if(!silent) emit scanModUpdate(action.modName, getMB(), d::X_FILES.arg(fileCount), modSize);
+        if(!silent && progress.ready()) emit scanModUpdate(action.modName, modSize, fileCount);
 
         return size;
     }
@@ -575,8 +695,25 @@
     {
         QFileInfo itrFi(path);
         if(itrFi.isSymLink() || !itrFi.isDir()) scanFile(itrFi, subtract);
-        else for(QDirIterator pathItr(path, QDir::NoDotAndDotDot|QDir::Files|QDir::Hidden|QDir::System, QDirIterator::Subdirectories);
-                 pathItr.hasNext(); scanFile(pathItr.fileInfo(), subtract)) pathItr.next();
+        else
+        {   // Size and type come from the listing; only links get a QFileInfo
+            QStringList dirs(path);
+            DirLister::Entry entry;
+            while(!dirs.isEmpty())
+            {
+                const QString dir = dirs.takeLast();
+                for(DirLister lister(dir); lister.next(entry); )
+                {
+                    if(entry.link)
+                    {
+                        const QFileInfo &fiLink(dir+"/"+entry.name);
+                        if(!fiLink.isDir()) scanFile(fiLink, subtract); // linked folders aren't followed
+                    }
+                    else if(entry.dir) dirs << dir+"/"+entry.name;
+                    else scanSize(entry.size, subtract);
+                }
+            }
+        }
     }
 
     ThreadAction::Result ThreadWorker::processFile(const QString &src, const QString &dst, const Mode &mode, const bool logBackups)
@@ -610,18 +747,27 @@
                 if(QFile::rename(src, dst))
                 {
                     result = ThreadAction::Success;
-                    removePath(fiSrc.absolutePath());
+                    touch(fiSrc.absolutePath());
                 }
                 break;
             case Copy:
-                if(QFile::copy(src, dst)) result = ThreadAction::Success;
+            {
+                Throttle throttle;
+                const CopyEngine::Result copied = CopyEngine::copy(src, dst, [&](const qint64 done, const qint64 total) {
+                    checkState();
+                    if(total > CopyEngine::CHUNK && throttle.ready()) // large file: show how far along it is
+                        emit progressUpdate(d::X_PERCENT_X.arg(fiSrc.fileName()).arg(done*100/total));
+                    return !action.aborted();
+                });
+                if(copied >= CopyEngine::Cloned) result = ThreadAction::Success;
                 break;
+            }
             case Delete:
                 if((fiSrc.isFile() && QFile(src).remove())
                     || (fiSrc.isSymLink() && fiSrc.isDir() && QDir().rmdir(src)))
                 {
                     result = ThreadAction::Success;
-                    removePath(fiSrc.absolutePath(), dst);
+                    touch(fiSrc.absolutePath(), dst);
                 }
             }
         }
@@ -642,85 +788,593 @@
     bool ThreadWorker::backup(const QString &src, const bool logBackups, QString dstMarked)
     {
         if(dstMarked.isEmpty()) dstMarked = src+extBackup+"%0";
-        QString backupPath = dstMarked.arg(QString());
 
-        for(int i=2; QFileInfo().exists(backupPath); ++i)
-            backupPath = dstMarked.arg(QString::number(i));
+        BackupManifest &manifest = BackupManifest::shared();
+        quint32 seq;
+        const QString &backupPath = manifest.allocate(dstMarked, seq);
 
         if(QFile::rename(src, backupPath))
         {
-            if(logBackups)
-            {
-                if(!backupFilesIt.is_open()) backupFilesIt.open(pathBackupFiles);
-                backupFilesIt << backupPath.toStdString() << std::endl;
-            }
-            
+            manifest.record(src, backupPath, seq, logBackups);
+            backups = true;
             return true;
         }
         else return false;
     }
 
-    void ThreadWorker::removePath(const QString &path, const QString &stopPath)
+    void ThreadWorker::restoreBackups()
     {
-        QDir dirEmpty(path);
-        dirEmpty.setFilter(QDir::NoDotAndDotDot|QDir::AllEntries|QDir::Hidden|QDir::System);
+        BackupManifest &manifest = BackupManifest::shared();
+
+        for(const BackupManifest::Entry &entry : manifest.restorable())
+        {
+            checkState();
+            if(action.aborted()) break;
 
-        while(dirEmpty.count() == 0) {
-            const QString &delPath = dirEmpty.absolutePath();
-            dirEmpty.cdUp();
+            emit progressUpdate(QFileInfo(entry.backup).fileName());
 
-            if(   delPath != stopPath
-               && delPath != pathMods
-               && delPath != pathGame
-               && (!stopPath.isEmpty() || dirEmpty.absolutePath() != pathMods))
+            const QFileInfo fiBackup(entry.backup), fiOriginal(entry.original);
+            if(!fiBackup.isSymLink() && !fiBackup.exists())
             {
-                if(!QDir().rmdir(delPath)) emit progressUpdate(d::FAILED_TO_DELETE_EMPTY_FOLDERc_X_.arg(delPath), true);
+                emit progressUpdate(d::MISSING_FILE_X.arg(entry.backup), true);
+                manifest.forget(entry.backup);
             }
-            else break;
+            else if(fiOriginal.isSymLink() || fiOriginal.exists()) // taken since (or by an older backup): leave it to Clean Up Backups
+            {
+                emit progressUpdate(d::FAILED_TO_X.arg(d::lMOVE+" "+d::lFILEc_X.arg(entry.backup)), true);
+                manifest.release(entry.backup);
+            }
+            else if(QDir().rename(entry.backup, entry.original)) manifest.forget(entry.backup); // files and folders
+            else emit progressUpdate(d::FAILED_TO_X.arg(d::lMOVE+" "+d::lFILEc_X.arg(entry.backup)), true);
         }
-    }
 
-    /********************************************************************/
-    /*      OBSOLETE - may be useful later      *************************/
-    /********************************************************************
+        manifest.save();
+    }
 
-        void ThreadWorker::mountModIterator(QString relativePath)
+    void ThreadWorker::mountOverlay()
+    {
+        Overlay overlay;
+        overlay.modName  = action.modName;
+        overlay.modRoot  = pathMods+"/"+action.modName;
+        overlay.gameRoot = pathGame;
+
+        // List the mod, creating the folders the game folder lacks on the way
+        emit statusUpdate(d::lLISTING_FILES___);
+        for(QStringList pending = { QString() }; !pending.isEmpty() && !action.aborted(); checkState())
         {
-            for(QDirIterator itMod(pathMods+"/"+action.modName+(!relativePath.isEmpty() ? "/"+relativePath : QString()),
-                                   QDir::NoDotAndDotDot|QDir::AllEntries|QDir::Hidden|QDir::System);
-                !action.aborted() && itMod.hasNext();
-                checkState())
+            const QString rel = pending.takeLast();
+
+            DirLister::Entry entry;
+            for(DirLister lister(rel.isEmpty() ? overlay.modRoot : overlay.modRoot+"/"+rel); lister.next(entry); )
             {
-                itMod.next();
-                const QString &src = itMod.filePath();
-                relativePath = src;
-                relativePath.remove(pathMods+"/"+action.modName+"/");
-                const QString &dst = pathGame+"/"+relativePath;
-                const QFileInfo &fiDst = QFileInfo(dst);
+                Overlay::Entry file;
+                file.rel = rel.isEmpty() ? entry.name : rel+"/"+entry.name;
 
-                if(!fiDst.isSymLink() && fiDst.exists() && fiDst.isDir()) mountModIterator(relativePath);
+                if(entry.link)
+                {
+                    if(QFileInfo(overlay.modRoot+"/"+file.rel).isDir()) file.kind = Overlay::DirLink;
+                }
+                else if(entry.dir)
+                {
+                    const QString &dst = pathGame+"/"+file.rel;
+                    const QFileInfo fiDst(dst);
+                    if(fiDst.isSymLink() || !fiDst.isDir())
+                    {
+                        if((fiDst.isSymLink() || fiDst.exists()) && !backup(dst, true))
+                        {
+                            emit progressUpdate(d::FAILED_TO_CREATE_BACKUP_X.arg(dst), true);
+                            action.add(ThreadAction::Failed);
+                            continue;
+                        }
+                        if(!QDir().mkdir(dst))
+                        {
+                            emit progressUpdate(d::FAILED_TO_CREATE_FOLDERc_X.arg(dst), true);
+                            action.add(ThreadAction::Failed);
+                            continue;
+                        }
+                        overlay.dirs << file.rel;
+                    }
+                    pending << file.rel;
+                    continue;
+                }
+
+                overlay.files.push_back(std::move(file));
+            }
+        }
+
+        // Link in parallel; whatever is in the way is backed up (restored by Unmount) and linked again
+        emit statusUpdate(d::lLINKING_FILES___);
+        const bool sameVolume = QStorageInfo(overlay.modRoot).rootPath() == QStorageInfo(pathGame).rootPath();
+        std::vector<Overlay::Result> results = overlayBatches(overlay, false, sameVolume);
+
+        std::vector<Overlay::Entry> linked;
+        linked.reserve(overlay.files.size());
+        for(size_t i=0; i < overlay.files.size(); ++i)
+        {
+            Overlay::Entry &file = overlay.files[i];
+            const QString &src = overlay.modRoot+"/"+file.rel,
+                          &dst = pathGame+"/"+file.rel;
+
+            if(results[i] == Overlay::Exists && !action.aborted())
+            {
+                checkState();
+                if(backup(dst, true)) results[i] = Overlay::link(src, dst, sameVolume, file.kind);
                 else
                 {
-                    emit progressUpdate(relativePath);
+                    emit progressUpdate(d::FAILED_TO_CREATE_BACKUP_X.arg(dst)+"\n"+d::SKIPPING_FILE_X.arg(src), true);
+                    action.add(ThreadAction::Failed);
+                    continue;
+                }
+            }
+
+            if(results[i] == Overlay::Done)
+            {
+                action.add(ThreadAction::Success);
+                linked.push_back(std::move(file));
+            }
+            else if(results[i] != Overlay::Skipped) // aborted before its batch got to it
+            {
+                emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_SYMLINK_TO+" "+d::lFILEc_X.arg(src)), true);
+                action.add(ThreadAction::Failed);
+            }
+        }
+        overlay.files = std::move(linked);
 
-                    const ThreadAction::Result &resultIt = processFile(src, dst, Link, true);
+        if(overlay.files.empty()) // nothing to unmount: take back the folders too
+            for(int i=overlay.dirs.size()-1; i >= 0; --i) QDir().rmdir(pathGame+"/"+overlay.dirs[i]);
+        else if(!overlay.save())
+            emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(Overlay::path()))), true);
+    }
 
-                    if(resultIt == ThreadAction::Success)
-                    {
-                        if(!outFilesIt.is_open()) outFilesIt.open(pathOutFiles);
-                        outFilesIt << dst.toStdString() << std::endl;
+    void ThreadWorker::unmountOverlay(Overlay &overlay)
+    {
+        emit statusUpdate(d::lREMOVING_LINKS___);
+        const std::vector<Overlay::Result> results = overlayBatches(overlay, true, false);
+
+        std::vector<Overlay::Entry> left; // still linked: the next Unmount picks them up
+        for(size_t i=0; i < overlay.files.size(); ++i)
+        {
+            const QString &dst = overlay.gameRoot+"/"+overlay.files[i].rel;
+
+            switch(results[i])
+            {
+            case Overlay::Done:
+                action.add(ThreadAction::Success);
+                break;
+            case Overlay::Missing:
+                action.add(ThreadAction::Missing);
+                emit progressUpdate(d::MISSING_FILE_X.arg(dst), true);
+                break;
+            case Overlay::Exists: // replaced since the mount: not ours any more
+                action.add(ThreadAction::Failed);
+                emit progressUpdate(d::NOT_A_SYMLINKc_X.arg(dst), true);
+                break;
+            case Overlay::Skipped:
+                left.push_back(std::move(overlay.files[i]));
+                break;
+            default:
+                action.add(ThreadAction::Failed);
+                emit progressUpdate(d::FAILED_TO_X.arg(d::lDELETE+" "+d::lFILEc_X.arg(dst)), true);
+                left.push_back(std::move(overlay.files[i]));
+            }
+        }
+        overlay.files = std::move(left);
+
+        // Folders the mount created, deepest first; one something else was put in stays
+        for(int i=overlay.dirs.size()-1; i >= 0; --i)
+            if(QDir().rmdir(overlay.gameRoot+"/"+overlay.dirs[i])) overlay.dirs.removeAt(i);
+
+        if(overlay.files.empty())
+        {
+            emit statusUpdate(d::lRESTORING_BACKUPS___);
+            restoreBackups();
+            Overlay::remove();
+        }
+        else overlay.save();
+    }
 
-                        const int beforeCount = fileCount;
-                        scanPath(src);
-                        action.add(resultIt, fileCount-beforeCount);
+    void ThreadWorker::mountLayers(const QStringList &layers)
+    {
+        const QString &farm = LayerStack::root(pathMods, action.modName);
+        LayerStack cached, stack;
+        if(!cached.load(pathMods, action.modName) || !QFileInfo(farm).isDir()) // what the farm holds from last time
+            cached.links.clear();
+        stack.layers = layers;
+
+        // Merged view: every layer over the ones below it
+        emit statusUpdate(d::lLISTING_FILES___);
+        for(const QString &layer : layers)
+        {
+            const QString &layerRoot = pathMods+"/"+layer;
+            if(!QFileInfo(layerRoot).isDir())
+            {
+                emit progressUpdate(d::MISSING_FILE_X.arg(layerRoot), true);
+                action.add(ThreadAction::Missing);
+                continue;
+            }
+
+            for(QStringList dirs = { QString() }; !dirs.isEmpty() && !action.aborted(); checkState())
+            {
+                const QString rel = dirs.takeLast();
+
+                DirLister::Entry entry;
+                for(DirLister lister(rel.isEmpty() ? layerRoot : layerRoot+"/"+rel); lister.next(entry); )
+                {
+                    LayerStack::Link link;
+                    link.rel = rel.isEmpty() ? entry.name : rel+"/"+entry.name;
+                    if(entry.dir && !entry.link)
+                    {
+                        dirs << link.rel;
+                        continue;
                     }
-                    else action.add(resultIt);
+                    if(entry.link && QFileInfo(layerRoot+"/"+link.rel).isDir()) continue; // linked folders aren't followed
+
+                    link.src = layerRoot+"/"+link.rel;
+                    stack.links[ConflictIndex::fold(link.rel)] = std::move(link);
+                }
+            }
+        }
+        if(action.aborted() || action.get(ThreadAction::Missing)) return;
+
+        // Only what differs from the farm as it is gets relinked
+        std::vector<LayerStack::Link *> stale, fresh;
+        QSet<QString> relink;
+        for(std::pair<const QString, LayerStack::Link> &old : cached.links)
+        {
+            const auto it = stack.links.find(old.first);
+            if(it == stack.links.end() || it->second.src != old.second.src
+               || (old.second.kind == Overlay::HardLink && fileId(farm+"/"+old.second.rel) != fileId(old.second.src)))
+            {
+                stale.push_back(&old.second);
+                if(it != stack.links.end()) relink.insert(old.first);
+            }
+            else it->second = old.second; // kept as it is, spelling and link kind included
+        }
+        for(std::pair<const QString, LayerStack::Link> &link : stack.links)
+            if(relink.contains(link.first) || cached.links.find(link.first) == cached.links.end()) fresh.push_back(&link.second);
+
+        emit statusUpdate(d::lREMOVING_LINKS___);
+        const std::vector<Overlay::Result> &unlinked = layerBatches(stale, farm, true);
+        for(size_t i=0; i < stale.size(); ++i)
+        {
+            if(unlinked[i] == Overlay::Done || unlinked[i] == Overlay::Missing) touch(QFileInfo(farm+"/"+stale[i]->rel).absolutePath(), farm);
+            else if(unlinked[i] != Overlay::Skipped)
+            {
+                emit progressUpdate(d::FAILED_TO_X.arg(d::lDELETE+" "+d::lFILEc_X.arg(farm+"/"+stale[i]->rel)), true);
+                action.add(ThreadAction::Failed);
+            }
+        }
+        pruneTouched();
+
+        emit statusUpdate(d::lLINKING_FILES___);
+        const std::vector<Overlay::Result> &linked = layerBatches(fresh, farm, false);
+        QSet<QString> dropped; // not in the farm: left out of the manifest, so the next mount tries again
+        for(size_t i=0; i < fresh.size(); ++i)
+        {
+            const QString &dst = farm+"/"+fresh[i]->rel;
+            const QFileInfo fiDst(dst);
+            if(linked[i] == Overlay::Exists && fiDst.isSymLink() && fiDst.symLinkTarget() == QFileInfo(fresh[i]->src).absoluteFilePath())
+                continue; // left by a mount whose manifest was lost
+            if(linked[i] != Overlay::Done)
+            {
+                if(linked[i] != Overlay::Skipped)
+                {
+                    emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_SYMLINK_TO+" "+d::lFILEc_X.arg(fresh[i]->src)), true);
+                    action.add(ThreadAction::Failed);
+                }
+                dropped.insert(ConflictIndex::fold(fresh[i]->rel));
+            }
+        }
+        for(const QString &key : dropped) stack.links.erase(key);
+
+        if(!stack.save(pathMods, action.modName))
+            emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(farm+".wmml"))), true);
+
+        if(action.aborted() || action.errors()) return;
+        action.add(ThreadAction::Success, int(stack.links.size()));
+        action.add(processFile(farm, pathGame+"/"+md::w3mod, Link));
+    }
+
+    std::vector<Overlay::Result> ThreadWorker::layerBatches(const std::vector<LayerStack::Link *> &links, const QString &root,
+                                                            const bool unlinking)
+    {
+        const size_t count = links.size();
+        std::vector<Overlay::Result> results(count, Overlay::Skipped);
+        QAtomicInt stop = action.aborted(), done = 0;
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+        for(size_t begin=0; begin < count; begin += Overlay::BATCH)
+            pool.start(new LayerJob(links, results, root, begin, std::min(begin+Overlay::BATCH, count), unlinking, stop, done));
+
+        while(!pool.waitForDone(50))
+        {
+            checkState();
+            if(action.aborted()) stop.storeRelease(1);
+            emit progressUpdate(d::X_PERCENT_X.arg(action.modName).arg(qint64(done.loadAcquire())*100/qint64(count)));
+        }
+
+        return results;
+    }
+
+    std::vector<Overlay::Result> ThreadWorker::overlayBatches(Overlay &overlay, const bool unlinking, const bool sameVolume)
+    {
+        const size_t count = overlay.files.size();
+        std::vector<Overlay::Result> results(count, Overlay::Skipped);
+        QAtomicInt stop = action.aborted(), done = 0;
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+        for(size_t begin=0; begin < count; begin += Overlay::BATCH)
+            pool.start(new OverlayJob(overlay, results, begin, std::min(begin+Overlay::BATCH, count),
+                                      unlinking, sameVolume, stop, done));
+
+        // This thread only keeps the dialog up to date and passes an abort on to the jobs
+        while(!pool.waitForDone(50))
+        {
+            checkState();
+            if(action.aborted()) stop.storeRelease(1);
+            emit progressUpdate(d::X_PERCENT_X.arg(action.modName).arg(qint64(done.loadAcquire())*100/qint64(count)));
+        }
+
+        return results;
+    }
+
+    void ThreadWorker::dedupMod(const QString &modName, const bool count)
+    {
+        ModStore &store = ModStore::shared();
+        ModStore::Pass pass;
+        const QString &modRoot = pathMods+"/"+modName;
+
+        for(QStringList dirs(modRoot); !dirs.isEmpty() && !action.aborted(); )
+        {
+            const QString dir = dirs.takeLast();
+
+            DirLister::Entry entry;
+            for(DirLister lister(dir); !action.aborted() && lister.next(entry); checkState())
+            {
+                const QString &path = dir+"/"+entry.name;
+                if(entry.link) continue; // links already share their target
+                if(entry.dir)
+                {
+                    dirs << path;
+                    continue;
+                }
+
+                if(progress.ready()) emit progressUpdate(QString(path).remove(0, modRoot.length()+1));
+
+                QString hash;
+                switch(store.dedup(path, entry.size, hash))
+                {
+                case ModStore::Skipped:
+                    break;
+                case ModStore::Failed:
+                    emit progressUpdate(d::FAILED_TO_X.arg(d::lDEDUPLICATE+" "+d::lFILEc_X.arg(path)), true);
+                    if(count) action.add(ThreadAction::Failed);
+                    break;
+                default: // Stored, Linked, Already
+                    pass.add(hash, entry.size);
+                    if(count) action.add(ThreadAction::Success);
+                }
+            }
+        }
+
+        if(!action.aborted()) store.commit(modName, std::move(pass)); // an aborted pass only leaves objects for sweep()
+    }
+
+    void ThreadWorker::verifyMod(const QString &modName, const bool accept)
+    {
+        const QString &modRoot = pathMods+"/"+modName;
+        ModManifest manifest;
+        const bool baseline = !manifest.load(modName); // nothing to compare with: this run records the mod as it is
+
+        // Files whose size and mtime match the manifest are taken as they are; only the rest is hashed
+        std::vector<HashEngine::File> files;
+        std::vector<std::pair<QString, qint64>> pending; // rel, mtime of files[i]
+        QSet<QString> seen;
+        for(QStringList dirs = { QString() }; !dirs.isEmpty() && !action.aborted(); checkState())
+        {
+            const QString rel = dirs.takeLast();
+
+            DirLister::Entry entry;
+            for(DirLister lister(rel.isEmpty() ? modRoot : modRoot+"/"+rel); lister.next(entry); )
+            {
+                const QString &fileRel = rel.isEmpty() ? entry.name : rel+"/"+entry.name;
+                if(entry.link) continue; // what a link points to isn't part of the mod
+                if(entry.dir)
+                {
+                    dirs << fileRel;
+                    continue;
+                }
+
+                seen.insert(fileRel);
+                const auto it = manifest.files.find(fileRel);
+                if(it != manifest.files.end() && it->second.size == entry.size && it->second.mtime == entry.mtime)
+                    action.add(ThreadAction::Success);
+                else
+                {
+                    HashEngine::File file;
+                    file.path = modRoot+"/"+fileRel;
+                    file.size = entry.size;
+                    files.push_back(std::move(file));
+                    pending.push_back({ fileRel, entry.mtime });
+                }
+            }
+        }
+
+        hashFiles(files, modName);
+
+        QStringList report;
+        bool changed = baseline;
+        for(size_t i=0; i < files.size(); ++i)
+        {
+            const HashEngine::File &file = files[i];
+            if(!file.ok)
+            {
+                if(action.aborted()) break;
+                emit progressUpdate(d::FAILED_TO_X.arg(d::lREAD+" "+d::lFILEc_X.arg(file.path)), true);
+                action.add(ThreadAction::Failed);
+                continue;
+            }
+
+            ModManifest::Entry current;
+            current.size  = file.size;
+            current.mtime = pending[i].second;
+            current.hash  = file.hash;
+
+            const auto it = manifest.files.find(pending[i].first);
+            if(it == manifest.files.end() || accept || it->second.hash == file.hash) // new, accepted or only touched
+            {
+                manifest.files[pending[i].first] = current;
+                changed = true;
+                action.add(ThreadAction::Success);
+            }
+            else
+            {
+                report << d::CHANGED_FILEc_X.arg(pending[i].first);
+                emit progressUpdate(d::CHANGED_FILEc_X.arg(file.path), true);
+                action.add(ThreadAction::Failed);
+            }
+        }
+
+        if(!action.aborted())
+            for(auto it = manifest.files.begin(); it != manifest.files.end(); )
+            {
+                if(seen.contains(it->first)) ++it;
+                else if(accept)
+                {
+                    it = manifest.files.erase(it);
+                    changed = true;
+                }
+                else
+                {
+                    report << d::MISSING_FILE_X.arg(it->first);
+                    emit progressUpdate(d::MISSING_FILE_X.arg(modRoot+"/"+it->first), true);
+                    action.add(ThreadAction::Missing);
+                    ++it;
                 }
             }
+
+        ModManifest::log(modName, report);
+        if(changed && !manifest.save(modName))
+            emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(ModManifest::path(modName)))), true);
+    }
+
+    void ThreadWorker::hashFiles(std::vector<HashEngine::File> &files, const QString &label)
+    {
+        qint64 total = 0;
+        for(const HashEngine::File &file : files) total += file.size;
+
+        QAtomicInt next = 0, stop = action.aborted();
+        QAtomicInteger<qint64> done = 0;
+
+        // Each job takes the next file until none are left; this thread only reports and passes an abort on
+        QThreadPool pool;
+        const int threads = std::max(QThread::idealThreadCount(), 1);
+        pool.setMaxThreadCount(threads);
+        for(int i=0; i < threads && size_t(i) < files.size(); ++i) pool.start(new HashJob(files, next, stop, done));
+
+        while(!pool.waitForDone(50))
+        {
+            checkState();
+            if(action.aborted()) stop.storeRelease(1);
+            emit progressUpdate(d::X_PERCENT_X.arg(label).arg(total ? done.loadAcquire()*100/total : 100));
+        }
+    }
+
+    void ThreadWorker::packMod(const QString &modName)
+    {
+        const QString &modRoot = pathMods+"/"+modName, &dst = modRoot+".mpq";
+        const QFileInfo &fiDst(dst);
+        if(fiDst.exists() || fiDst.isSymLink())
+        {
+            emit progressUpdate(d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(dst)))+": "+d::lEXISTS, true);
+            action.add(ThreadAction::Failed);
+            return;
         }
-     ********************************************************************/
-    /********************************************************************/
-    /********************************************************************/
+
+        // Links to files are packed as what they point to; linked folders aren't followed
+        std::vector<MpqWriter::File> files;
+        for(QStringList dirs = { QString() }; !dirs.isEmpty() && !action.aborted(); checkState())
+        {
+            const QString rel = dirs.takeLast();
+
+            DirLister::Entry entry;
+            for(DirLister lister(rel.isEmpty() ? modRoot : modRoot+"/"+rel); lister.next(entry); )
+            {
+                const QString &fileRel = rel.isEmpty() ? entry.name : rel+"/"+entry.name;
+                MpqWriter::File file;
+                file.path = modRoot+"/"+fileRel;
+                file.size = entry.size;
+
+                if(entry.link)
+                {
+                    const QFileInfo &fiLink(file.path);
+                    if(fiLink.isDir() || !fiLink.exists()) continue;
+                    file.size = fileSize(fiLink);
+                }
+                else if(entry.dir)
+                {
+                    dirs << fileRel;
+                    continue;
+                }
+
+                file.name = QString(fileRel).replace('/', '\\');
+                files.push_back(std::move(file));
+            }
+        }
+        if(action.aborted()) return;
+
+        QString failedPath;
+        const MpqWriter::Result result = MpqWriter::pack(dst, files, [&](const qint64 done, const qint64 total) {
+            checkState();
+            emit progressUpdate(d::X_PERCENT_X.arg(modName).arg(total ? done*100/total : 100));
+            return !action.aborted();
+        }, &failedPath);
+
+        switch(result)
+        {
+        case MpqWriter::Packed:    action.add(ThreadAction::Success, int(files.size()));
+            break;
+        case MpqWriter::Cancelled: break;
+        case MpqWriter::TooLarge:  emit progressUpdate(d::X_TOO_LARGE_TO_PACK.arg(modName), true);
+                                   action.add(ThreadAction::Failed);
+            break;
+        case MpqWriter::Failed:    emit progressUpdate(failedPath.isEmpty()
+                                                       ? d::FAILED_TO_X.arg(d::lCREATE_X.arg(d::lFILEc_X.arg(dst)))
+                                                       : d::FAILED_TO_X.arg(d::lREAD+" "+d::lFILEc_X.arg(failedPath)), true);
+                                   action.add(ThreadAction::Failed);
+        }
+    }
+
+    void ThreadWorker::pruneTouched()
+    {
+        // Deepest first: a folder is only looked at once everything below it has been pruned
+        auto deeper = [](const QString &a, const QString &b) {
+            const int depthA = a.count('/'), depthB = b.count('/');
+            return depthA != depthB ? depthA > depthB : a < b;
+        };
+        std::map<QString, QString, decltype(deeper)> queue(touched.begin(), touched.end(), deeper);
+        touched.clear();
+
+        while(!queue.empty())
+        {
+            const QString delPath = queue.begin()->first, stopPath = queue.begin()->second;
+            queue.erase(queue.begin());
+
+            const QString &parent = QFileInfo(delPath).absolutePath();
+            if(   delPath == stopPath
+               || delPath == pathMods
+               || delPath == pathGame
+               || (stopPath.isEmpty() && parent == pathMods)
+               || !QFileInfo(delPath).isDir()
+               || QDirIterator(delPath, QDir::NoDotAndDotDot|QDir::AllEntries|QDir::Hidden|QDir::System).hasNext()) // not empty
+                continue;
+
+            if(QDir().rmdir(delPath)) queue.insert({ parent, stopPath }); // parent may be empty now
+            else emit progressUpdate(d::FAILED_TO_DELETE_EMPTY_FOLDERc_X_.arg(delPath), true);
+        }
+    }
 
 /********************************************************************/
 /*      THREAD CONTROLLER       *************************************/
@@ -751,10 +1405,6 @@
                 connect(worker, &ThreadWorker::modDataReady, this, &Thread::modDataReady);
                 connect(worker, &ThreadWorker::modDataReady, this, &Thread::deleteLater);
                 break;
-            case ThreadAction::Scan: case ThreadAction::ScanEx:
-                connect(worker, &ThreadWorker::scanModReady, this, &Thread::scanModReady);
-                connect(worker, &ThreadWorker::scanModReady, this, &Thread::deleteLater);
-                break;
             case ThreadAction::Shortcut:
                 connect(worker, &ThreadWorker::shortcutReady, this, &Thread::shortcutReady);
                 connect(worker, &ThreadWorker::shortcutReady, this, &Thread::deleteLater);
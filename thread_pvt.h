@@ -2,12 +2,18 @@
 #define THREAD_PVT_H
 
 #include "_moddata.h"
+#include "_throttle.h"
 #include "threadbase.h"
+#include "overlay.h"
+#include "hashengine.h"
+#include "layerstack.h"
 #include <QDialog>
+#include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QCoreApplication>
 #include <QFileInfo>
-#include <fstream>
+#include <map>
 
 #include <QDebug>
 
@@ -15,7 +21,6 @@ class Msgr;
 class QLabel;
 class QDialogButtonBox;
 class QPlainTextEdit;
-class QWaitCondition;
 
 class ProgressDiag : public QDialog
 {
@@ -47,6 +52,21 @@ signals:       void aborted();
                //void unmountForced();
 };
 
+/* Deletes the sources of a cross-volume move on its own thread,
+ * so unlinking one file overlaps with copying the next */
+class Unlinker : public QThread
+{
+               QMutex         mutex;
+               QWaitCondition queued;
+               QStringList    paths, failed;
+               bool           closed = false;
+
+public:        void push(const QString &path);
+               QStringList finish(); // waits for the queue to drain, returns what couldn't be deleted
+
+private:       void run() override;
+};
+
 class ThreadWorker : public ThreadBase
 {
     Q_OBJECT
@@ -54,17 +74,18 @@ class ThreadWorker : public ThreadBase
               enum Mode { Move, Copy, Link, Delete };
               static const QString extBackup;
 
-              const QString     pathMods, pathGame;
-              const std::string pathOutFiles    = QCoreApplication::applicationDirPath().toStdString()+"/out_files.txt",
-                                pathBackupFiles = QCoreApplication::applicationDirPath().toStdString()+"/backup_files.txt";
-              std::ofstream     outFilesIt, backupFilesIt;
+              const QString pathMods, pathGame;
 
               Msgr         *const msgr;
               ThreadAction &action;
 
               bool &paused;
               qint64 modSize=0;
-              int fileCount=0;
+              int fileCount=0,
+                  linkCount=0; // files whose size came from following a link
+              Throttle progress;
+              bool backups=false; // the backup manifest needs saving
+              std::map<QString, QString> touched; // folders files left this action -> stopPath, see pruneTouched()
 
 public:       ThreadWorker(ThreadAction &action, bool &paused, const QString &pathMods, const QString &pathGame, Msgr *const msgr)
                 : ThreadBase(),
@@ -76,22 +97,35 @@ public:       ThreadWorker(ThreadAction &action, bool &paused, const QString &pa
               { confirmWait = waitCond; this->mutex = mutex; }
 
 public slots: void init(const qint64 index=0, const QString &data1=QString(), const QString &data2=QString(),
-                        const QString &args=QString(), const md::modData &modData={});
+                        const QString &args=QString(), const md::Registry &registry={});
 
               //void forceUnmount();
 
 private:      void    checkState();
-              QString getMB();
-              void    getFileCount(QString qsFileCount);
-              void    mountModIterator(QString relativePath=QString());
 
               qint64 scanFile(const QFileInfo &fi, const bool subtract=false,  const bool silent=false);
+              qint64 scanSize(const qint64 size,   const bool subtract=false,  const bool silent=false);
               void   scanPath(const QString &path, const bool subtract=false);
 
+              int  modRow() const;
+              bool moveTree(const QString &src, const QString &dst);
+
               ThreadAction::Result processFile(const QString &src, const QString &dst,
                                                const Mode &mode=Move, const bool logBackups=false);
-              bool backup(const QString &src, const bool logBackups=false, QString dstMarked=QString());
-              void removePath(const QString &path, const QString &stopPath=QString());
+              bool backup(const QString &src, const bool logBackups=false, QString dstMarked=QString()); // logBackups: restore on unmount
+              void restoreBackups();
+              void mountOverlay();
+              void unmountOverlay(Overlay &overlay);
+              std::vector<Overlay::Result> overlayBatches(Overlay &overlay, const bool unlinking, const bool sameVolume);
+              void mountLayers(const QStringList &layers); // bottom first; action.modName: the stack's name
+              std::vector<Overlay::Result> layerBatches(const std::vector<LayerStack::Link *> &links, const QString &root,
+                                                        const bool unlinking);
+              void dedupMod(const QString &modName, const bool count=true); // count: add to the action's results
+              void verifyMod(const QString &modName, const bool accept); // accept: changes become the new baseline
+              void hashFiles(std::vector<HashEngine::File> &files, const QString &label);
+              void packMod(const QString &modName); // into <mod>.mpq next to it
+              void touch(const QString &path, const QString &stopPath=QString()) { touched.insert({ path, stopPath }); }
+              void pruneTouched(); // one bottom-up pass over the folders files were moved or deleted from
 
 signals:      void progressUpdate(const QString &msg, const bool error=false);
               void statusUpdate  (const QString &msg);
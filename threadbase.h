@@ -6,10 +6,12 @@
 
 class QWaitCondition;
 class QMutex;
+class QFileInfo;
 
 class ThreadAction {
-public:  enum Action { NoAction, Mount, Unmount, ModData, Scan, ScanEx, Add, Delete, Shortcut };
+public:  enum Action { NoAction, Mount, Unmount, ModData, Add, Delete, Shortcut, Dedup, Verify, Pack, Action_Size };
          enum Result { Success, Failed, Missing, Result_Size };
+         enum ScanMode { FullScan, IndexedScan }; // IndexedScan: only re-walk folders whose mtime changed
 
 private: std::array<int, size_t(Result_Size)> results{};
          bool isAborted = false; //, isForced = false;
@@ -63,8 +65,14 @@ protected:
            QMutex         *mutex=nullptr;
            ThreadBase() : QObject() {}
 
-signals:   void modDataReady(const md::modData &modData, const QStringList &modNames);
-           void scanModUpdate(const QString &modName, const QString &modSize, const QString &fileCount, const qint64 size);
+public:    static QString getMB(const qint64 size);
+           static const int MAX_LINK_HOPS = 63; // same limit as the Windows path parser
+
+           static qint64  fileSize(const QFileInfo &fi, int *links=nullptr);
+           static quint64 fileId  (const QString &path);
+
+signals:   void modDataReady(const md::Diff &diff);
+           void scanModUpdate(const QString &modName, const qint64 size, const int fileCount, const int links=0);
            void scanModReady (const QString &modName);
            void modAdded     (const QString &modName, const int row, const bool addData=true);
            void modDeleted   (const QString &modName);